@@ -0,0 +1,134 @@
+// Compares the catalog work of a collection crawl, walking the tree with
+// recursive_collection_iterator and querying each data object for its
+// resources as the plugin did before, with the single paged GenQuery the
+// crawl now issues.  Runs as a client of the zone in the irods environment
+// against an existing collection, without scheduling anything.
+//
+//     g++ -std=c++17 -O2 -o collection_crawl collection_crawl.cpp \
+//         -I/usr/include/irods -I${IRODS_EXTERNALS}/boost/include \
+//         -L${IRODS_EXTERNALS}/boost/lib -lirods_client -lirods_common \
+//         -lboost_filesystem -lboost_system -lpthread
+//     ./collection_crawl /tempZone/home/rods/large_collection
+
+#include "rodsClient.h"
+#include "irods_client_api_table.hpp"
+#include "irods_pack_table.hpp"
+#include "irods_query.hpp"
+#include "filesystem.hpp"
+
+#include <boost/format.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace {
+    namespace fs  = irods::experimental::filesystem;
+    namespace fsc = irods::experimental::filesystem::client;
+
+    rcComm_t* connect() {
+        rodsEnv env{};
+        if(getRodsEnv(&env) < 0) {
+            return nullptr;
+        }
+
+        rErrMsg_t err{};
+        rcComm_t* comm = rcConnect(env.rodsHost, env.rodsPort, env.rodsUserName, env.rodsZone, 0, &err);
+        if(comm && clientLogin(comm) < 0) {
+            rcDisconnect(comm);
+            return nullptr;
+        }
+
+        return comm;
+    } // connect
+
+    // the walk and the per object resource query of the previous crawl
+    std::size_t crawl_by_iterator(
+        rcComm_t&          _comm,
+        const std::string& _collection_name) {
+        std::size_t count{};
+        for(const auto& entry : fsc::recursive_collection_iterator(_comm, fs::path{_collection_name})) {
+            if(!fsc::is_data_object(_comm, entry.path())) {
+                continue;
+            }
+
+            const std::string query_str{
+                boost::str(
+                    boost::format("SELECT RESC_NAME WHERE DATA_NAME = '%s' AND COLL_NAME = '%s'")
+                    % entry.path().object_name().string()
+                    % entry.path().parent_path().string())};
+            irods::query<rcComm_t> qobj{&_comm, query_str, 1};
+            count += qobj.size() > 0;
+        }
+
+        return count;
+    } // crawl_by_iterator
+
+    // the single paged query of the current crawl, one row per replica
+    std::size_t crawl_by_query(
+        rcComm_t&          _comm,
+        const std::string& _collection_name) {
+        const std::string query_str{
+            boost::str(
+                boost::format("SELECT COLL_NAME, DATA_NAME, ORDER(DATA_ID), RESC_NAME, DATA_SIZE WHERE COLL_NAME = '%s' || like '%s/%%'")
+                % _collection_name
+                % _collection_name)};
+
+        std::size_t count{};
+        std::string current_data_id;
+        irods::query<rcComm_t> qobj{&_comm, query_str};
+        for(const auto& row : qobj) {
+            if(row[2] != current_data_id) {
+                current_data_id = row[2];
+                ++count;
+            }
+        }
+
+        return count;
+    } // crawl_by_query
+
+    template<typename F>
+    void run(const char* _label, F _crawl, rcComm_t& _comm, const std::string& _collection_name) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto count = _crawl(_comm, _collection_name);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::printf(
+            "%-20s %8zu objects in %8.3f s, %10.1f objects/s\n",
+            _label,
+            count,
+            elapsed.count(),
+            count / elapsed.count());
+    } // run
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if(argc < 2) {
+        std::fprintf(stderr, "usage: %s <collection>\n", argv[0]);
+        return 1;
+    }
+
+    auto& api_table = irods::get_client_api_table();
+    auto& pack_table = irods::get_pack_table();
+    init_api_table(api_table, pack_table);
+
+    rcComm_t* comm = connect();
+    if(!comm) {
+        std::fprintf(stderr, "failed to connect to the zone in the irods environment\n");
+        return 1;
+    }
+
+    const std::string collection_name{argv[1]};
+    try {
+        run("iterator and lookup", crawl_by_iterator, *comm, collection_name);
+        run("paged query", crawl_by_query, *comm, collection_name);
+    }
+    catch(const std::exception& _e) {
+        std::fprintf(stderr, "crawl failed [%s]\n", _e.what());
+        rcDisconnect(comm);
+        return 1;
+    }
+
+    rcDisconnect(comm);
+    return 0;
+}
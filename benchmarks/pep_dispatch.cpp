@@ -0,0 +1,156 @@
+// Compares rule_exists as a std::set built on every call, as the plugin
+// did before, with the compile time perfect hash table of
+// libirods_rule_engine_plugin-indexing.cpp.  The table is copied here with
+// no-op handlers so the driver needs no iRODS headers, and must be kept in
+// step with the plugin by hand.
+//
+//     g++ -std=c++17 -O2 -o pep_dispatch pep_dispatch.cpp
+//     ./pep_dispatch [iterations]
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    using pep_handler = void (*)();
+
+    void handle_pep() {}
+
+    struct pep_entry {
+        std::string_view name;
+        pep_handler      handler;
+    }; // struct pep_entry
+
+    constexpr std::array<pep_entry, 12> peps{{
+        {"pep_api_data_obj_put_post",     handle_pep},
+        {"pep_api_data_obj_repl_post",    handle_pep},
+        {"pep_api_data_obj_close_pre",    handle_pep},
+        {"pep_api_data_obj_close_post",   handle_pep},
+        {"pep_api_mod_avu_metadata_pre",  handle_pep},
+        {"pep_api_mod_avu_metadata_post", handle_pep},
+        {"pep_api_data_obj_unlink_post",  handle_pep},
+        {"pep_api_phy_path_reg_post",     handle_pep},
+        {"pep_api_data_obj_rename_post",  handle_pep},
+        {"pep_api_atomic_apply_metadata_operations_pre",  handle_pep},
+        {"pep_api_atomic_apply_metadata_operations_post", handle_pep},
+        {"pep_api_atomic_apply_metadata_operations_finally", handle_pep}}};
+
+    constexpr std::size_t pep_table_size{64};
+
+    constexpr std::uint64_t pep_hash(
+        std::string_view _name,
+        std::uint64_t    _seed) {
+        // fnv-1a
+        std::uint64_t hash{14695981039346656037ull ^ _seed};
+        for(const char c : _name) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    } // pep_hash
+
+    constexpr std::uint64_t max_pep_seed{1024};
+
+    constexpr std::uint64_t find_pep_seed() {
+        for(std::uint64_t seed = 0; seed < max_pep_seed; ++seed) {
+            std::array<bool, pep_table_size> used{};
+            bool perfect{true};
+            for(const auto& pep : peps) {
+                auto& slot = used[pep_hash(pep.name, seed) % pep_table_size];
+                if(slot) {
+                    perfect = false;
+                    break;
+                }
+                slot = true;
+            }
+
+            if(perfect) {
+                return seed;
+            }
+        }
+
+        return max_pep_seed;
+    } // find_pep_seed
+
+    constexpr std::uint64_t pep_seed{find_pep_seed()};
+    static_assert(pep_seed < max_pep_seed, "no perfect hash for the pep table, increase pep_table_size");
+
+    constexpr std::array<pep_entry, pep_table_size> make_pep_table() {
+        std::array<pep_entry, pep_table_size> table{};
+        for(const auto& pep : peps) {
+            table[pep_hash(pep.name, pep_seed) % pep_table_size] = pep;
+        }
+
+        return table;
+    } // make_pep_table
+
+    constexpr auto pep_table = make_pep_table();
+
+    bool rule_exists_table(const std::string& _rn) {
+        const auto& entry = pep_table[pep_hash(_rn, pep_seed) % pep_table_size];
+        return entry.name == _rn && nullptr != entry.handler;
+    } // rule_exists_table
+
+    bool rule_exists_set(const std::string& _rn) {
+        const std::set<std::string> rules{
+                                        "pep_api_data_obj_repl_post",
+                                        "pep_api_data_obj_unlink_post",
+                                        "pep_api_mod_avu_metadata_pre",
+                                        "pep_api_mod_avu_metadata_post",
+                                        "pep_api_data_obj_close_pre",
+                                        "pep_api_data_obj_close_post",
+                                        "pep_api_data_obj_put_post",
+                                        "pep_api_phy_path_reg_post",
+                                        "pep_api_data_obj_rename_post",
+                                        "pep_api_atomic_apply_metadata_operations_pre",
+                                        "pep_api_atomic_apply_metadata_operations_post",
+                                        "pep_api_atomic_apply_metadata_operations_finally"};
+        return rules.find(_rn) != rules.end();
+    } // rule_exists_set
+
+    // the peps of a put, mostly ones this plugin does not handle
+    const std::vector<std::string> probes{
+        "pep_api_auth_request_pre",
+        "pep_api_auth_request_post",
+        "pep_api_obj_stat_pre",
+        "pep_api_obj_stat_post",
+        "pep_api_data_obj_put_pre",
+        "pep_resource_resolve_hierarchy_pre",
+        "pep_resource_create_pre",
+        "pep_resource_write_post",
+        "pep_api_data_obj_close_pre",
+        "pep_api_data_obj_close_post",
+        "pep_api_data_obj_put_post",
+        "pep_api_mod_avu_metadata_pre"};
+
+    template<typename F>
+    void run(const char* _label, F _rule_exists, std::size_t _iterations) {
+        std::size_t found{};
+        const auto start = std::chrono::steady_clock::now();
+        for(std::size_t i = 0; i < _iterations; ++i) {
+            found += _rule_exists(probes[i % probes.size()]);
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::printf(
+            "%-20s %12.0f calls/s (%zu of %zu found)\n",
+            _label,
+            _iterations / elapsed.count(),
+            found,
+            _iterations);
+    } // run
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    run("std::set per call", rule_exists_set, iterations);
+    run("perfect hash table", rule_exists_table, iterations);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Measures the latency of each put into an indexed collection, where the
+// indexing peps run within the api call.  Run it once with the default
+// event_buffer_size of zero, which schedules each event as it arrives, and
+// once with event buffering enabled to compare.  Runs as a client of the
+// zone in the irods environment, the objects are left in the collection.
+//
+//     g++ -std=c++17 -O2 -o put_latency put_latency.cpp \
+//         -I/usr/include/irods -I${IRODS_EXTERNALS}/boost/include \
+//         -L${IRODS_EXTERNALS}/boost/lib -lirods_client -lirods_common \
+//         -lboost_filesystem -lboost_system -lpthread
+//     ./put_latency /tempZone/home/rods/indexed [count] [size]
+
+#include "rodsClient.h"
+#include "dataObjPut.h"
+#include "irods_client_api_table.hpp"
+#include "irods_pack_table.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+    rcComm_t* connect() {
+        rodsEnv env{};
+        if(getRodsEnv(&env) < 0) {
+            return nullptr;
+        }
+
+        rErrMsg_t err{};
+        rcComm_t* comm = rcConnect(env.rodsHost, env.rodsPort, env.rodsUserName, env.rodsZone, 0, &err);
+        if(comm && clientLogin(comm) < 0) {
+            rcDisconnect(comm);
+            return nullptr;
+        }
+
+        return comm;
+    } // connect
+
+    double percentile(const std::vector<double>& _sorted, double _p) {
+        const auto i = static_cast<std::size_t>(_p * (_sorted.size() - 1));
+        return _sorted[i];
+    } // percentile
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if(argc < 2) {
+        std::fprintf(stderr, "usage: %s <collection> [count] [size]\n", argv[0]);
+        return 1;
+    }
+
+    const std::string collection_name{argv[1]};
+    const int         count = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const std::size_t size  = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1024;
+
+    // one local file is put repeatedly under distinct names
+    char local_file[] = "/tmp/put_latency_XXXXXX";
+    const int fd = mkstemp(local_file);
+    if(fd < 0) {
+        std::fprintf(stderr, "failed to create a local file\n");
+        return 1;
+    }
+    close(fd);
+    std::ofstream{local_file} << std::string(size, 'x');
+
+    auto& api_table = irods::get_client_api_table();
+    auto& pack_table = irods::get_pack_table();
+    init_api_table(api_table, pack_table);
+
+    rcComm_t* comm = connect();
+    if(!comm) {
+        std::fprintf(stderr, "failed to connect to the zone in the irods environment\n");
+        unlink(local_file);
+        return 1;
+    }
+
+    std::vector<double> latencies;
+    const auto pid = std::to_string(getpid());
+    for(int i = 0; i < count; ++i) {
+        const std::string object_path{collection_name + "/put_latency_" + pid + "_" + std::to_string(i)};
+
+        dataObjInp_t put_inp{};
+        rstrcpy(put_inp.objPath, object_path.c_str(), MAX_NAME_LEN);
+        put_inp.dataSize = size;
+        put_inp.oprType  = PUT_OPR;
+        addKeyVal(&put_inp.condInput, FORCE_FLAG_KW, "");
+
+        const auto start = std::chrono::steady_clock::now();
+        const int status = rcDataObjPut(comm, &put_inp, local_file);
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        clearKeyVal(&put_inp.condInput);
+        if(status < 0) {
+            std::fprintf(stderr, "put of [%s] failed [%d]\n", object_path.c_str(), status);
+            continue;
+        }
+
+        latencies.push_back(elapsed.count());
+    }
+
+    rcDisconnect(comm);
+    unlink(local_file);
+
+    if(latencies.empty()) {
+        return 1;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    std::printf(
+        "%zu puts of %zu bytes, mean %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+        latencies.size(),
+        size,
+        std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size(),
+        percentile(latencies, 0.50),
+        percentile(latencies, 0.99),
+        latencies.back());
+    return 0;
+}
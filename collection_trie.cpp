@@ -0,0 +1,132 @@
+
+#include "collection_trie.hpp"
+
+#include <algorithm>
+
+namespace irods {
+    namespace indexing {
+        std::vector<std::string> collection_trie::split(
+            const std::string& _path) {
+            std::vector<std::string> ret_val;
+            std::string::size_type start{};
+            while(start < _path.size()) {
+                auto end = _path.find('/', start);
+                if(std::string::npos == end) {
+                    end = _path.size();
+                }
+
+                if(end > start) {
+                    ret_val.push_back(_path.substr(start, end - start));
+                }
+
+                start = end + 1;
+            }
+
+            return ret_val;
+        } // split
+
+        void collection_trie::insert(
+            const std::string& _collection_name,
+            const std::string& _value,
+            const std::string& _units) {
+            node* n = &root_;
+            for(const auto& elem : split(_collection_name)) {
+                auto& child = n->children[elem];
+                if(!child) {
+                    child = std::make_unique<node>();
+                }
+                n = child.get();
+            }
+
+            const auto entry = std::make_pair(_value, _units);
+            if(std::find(n->metadata.begin(), n->metadata.end(), entry) == n->metadata.end()) {
+                n->metadata.push_back(entry);
+                ++size_;
+            }
+        } // insert
+
+        void collection_trie::erase(
+            const std::string& _collection_name) {
+            node* n = &root_;
+            for(const auto& elem : split(_collection_name)) {
+                auto itr = n->children.find(elem);
+                if(n->children.end() == itr) {
+                    return;
+                }
+                n = itr->second.get();
+            }
+
+            size_ -= n->metadata.size();
+            n->metadata.clear();
+        } // erase
+
+        const collection_trie::node* collection_trie::find(
+            const std::string& _path) const {
+            const node* n = &root_;
+            for(const auto& elem : split(_path)) {
+                auto itr = n->children.find(elem);
+                if(n->children.end() == itr) {
+                    return nullptr;
+                }
+                n = itr->second.get();
+            }
+
+            return n;
+        } // find
+
+        bool collection_trie::contains(
+            const std::string& _collection_name,
+            const std::string& _value,
+            const std::string& _units) const {
+            const auto n = find(_collection_name);
+            if(!n) {
+                return false;
+            }
+
+            const auto entry = std::make_pair(_value, _units);
+            return std::find(n->metadata.begin(), n->metadata.end(), entry) != n->metadata.end();
+        } // contains
+
+        collection_trie::metadata_results collection_trie::metadata_for_path(
+            const std::string& _path) const {
+            // gather root first along the path, then reverse for nearest first
+            std::vector<const node*> nodes{&root_};
+            const node* n = &root_;
+            for(const auto& elem : split(_path)) {
+                auto itr = n->children.find(elem);
+                if(n->children.end() == itr) {
+                    break;
+                }
+                n = itr->second.get();
+                nodes.push_back(n);
+            }
+
+            metadata_results ret_val;
+            for(auto itr = nodes.rbegin(); itr != nodes.rend(); ++itr) {
+                ret_val.insert(ret_val.end(), (*itr)->metadata.begin(), (*itr)->metadata.end());
+            }
+
+            return ret_val;
+        } // metadata_for_path
+
+        void collection_trie::collect(
+            const node&       _node,
+            metadata_results& _results) {
+            _results.insert(_results.end(), _node.metadata.begin(), _node.metadata.end());
+            for(const auto& child : _node.children) {
+                collect(*child.second, _results);
+            }
+        } // collect
+
+        collection_trie::metadata_results collection_trie::metadata_within_path(
+            const std::string& _path) const {
+            metadata_results ret_val;
+            const auto n = find(_path);
+            if(n) {
+                collect(*n, ret_val);
+            }
+
+            return ret_val;
+        } // metadata_within_path
+    } // namespace indexing
+} // namespace irods
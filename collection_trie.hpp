@@ -0,0 +1,58 @@
+#ifndef COLLECTION_TRIE_HPP
+#define COLLECTION_TRIE_HPP
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace irods {
+    namespace indexing {
+        // prefix tree of logical collection paths, each node holding the
+        // indexing metadata (value, units) annotated on that collection
+        class collection_trie {
+            public:
+            using metadata_results = std::vector<std::pair<std::string, std::string>>;
+
+            void insert(
+                const std::string& _collection_name,
+                const std::string& _value,
+                const std::string& _units);
+
+            void erase(const std::string& _collection_name);
+
+            bool contains(
+                const std::string& _collection_name,
+                const std::string& _value,
+                const std::string& _units) const;
+
+            // metadata found on _path and each of its ancestors, nearest first
+            metadata_results metadata_for_path(const std::string& _path) const;
+
+            // metadata found on _path and each of its descendants
+            metadata_results metadata_within_path(const std::string& _path) const;
+
+            std::size_t size() const { return size_; }
+
+            private:
+            struct node {
+                std::unordered_map<std::string, std::unique_ptr<node>> children;
+                metadata_results                                        metadata;
+            };
+
+            static std::vector<std::string> split(const std::string& _path);
+
+            const node* find(const std::string& _path) const;
+
+            static void collect(
+                const node&       _node,
+                metadata_results& _results);
+
+            node        root_;
+            std::size_t size_{};
+        }; // class collection_trie
+    } // namespace indexing
+} // namespace irods
+
+#endif // COLLECTION_TRIE_HPP
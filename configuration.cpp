@@ -2,23 +2,106 @@
 #include "configuration.hpp"
 #include "plugin_specific_configuration.hpp"
 
+#include <mutex>
+
 namespace irods {
     namespace indexing {
+        namespace {
+            std::mutex configurations_mutex;
+            std::map<std::string, std::shared_ptr<const configuration>> configurations;
+        } // namespace
+
         configuration::configuration(
             const std::string& _instance_name ) :
             instance_name_{_instance_name} {
             try {
-                auto cfg = get_plugin_specific_configuration(_instance_name);
+                // read before the file so a concurrent edit is seen again
+                modify_time_ = get_server_config_modify_time();
+                auto cfg = read_plugin_specific_configuration(_instance_name);
                 auto capture_parameter = [&](const std::string& _param, std::string& _attr) {
                     if(cfg.find(_param) != cfg.end()) {
                         _attr = boost::any_cast<std::string>(cfg.at(_param));
                     }
                 }; // capture_parameter
 
+                auto capture_integer_parameter = [&](const std::string& _param, int& _attr) {
+                    if(cfg.find(_param) != cfg.end()) {
+                        _attr = boost::any_cast<int>(cfg.at(_param));
+                    }
+                }; // capture_integer_parameter
+
+                auto capture_boolean_parameter = [&](const std::string& _param, bool& _attr) {
+                    if(cfg.find(_param) != cfg.end()) {
+                        _attr = boost::any_cast<bool>(cfg.at(_param));
+                    }
+                }; // capture_boolean_parameter
+
                 capture_parameter("index", index);
                 capture_parameter("minimum_delay_time", minimum_delay_time);
                 capture_parameter("maximum_delay_time", maximum_delay_time);
                 capture_parameter("delay_parameters",   delay_parameters);
+                capture_parameter("execution_mode",     execution_mode);
+                capture_parameter("read_cost_attribute", read_cost_attribute);
+
+                capture_integer_parameter("collection_batch_size", collection_batch_size);
+                if(collection_batch_size < 1) {
+                    collection_batch_size = 1;
+                }
+
+                capture_integer_parameter("collection_crawl_fan_out", collection_crawl_fan_out);
+                capture_integer_parameter("collection_crawl_checkpoint_interval", collection_crawl_checkpoint_interval);
+                capture_integer_parameter("reconcile_page_size", reconcile_page_size);
+                if(reconcile_page_size < 1) {
+                    reconcile_page_size = 1;
+                }
+                capture_integer_parameter("resource_cache_ttl_in_seconds", resource_cache_ttl_in_seconds);
+                capture_integer_parameter("collection_cache_ttl_in_seconds", collection_cache_ttl_in_seconds);
+                capture_integer_parameter("event_buffer_size", event_buffer_size);
+                capture_integer_parameter("event_buffer_flush_interval_in_seconds", event_buffer_flush_interval_in_seconds);
+                capture_integer_parameter("metadata_priority", metadata_priority);
+                capture_integer_parameter("small_full_text_priority", small_full_text_priority);
+                capture_integer_parameter("large_full_text_priority", large_full_text_priority);
+                capture_integer_parameter("bulk_priority", bulk_priority);
+                capture_integer_parameter("large_object_size_in_bytes", large_object_size_in_bytes);
+                capture_integer_parameter("worker_thread_count", worker_thread_count);
+                if(worker_thread_count < 1) {
+                    worker_thread_count = 1;
+                }
+
+                capture_integer_parameter("worker_queue_size", worker_queue_size);
+                if(worker_queue_size < 1) {
+                    worker_queue_size = 1;
+                }
+
+                capture_integer_parameter("remote_replica_cost", remote_replica_cost);
+                capture_integer_parameter("archive_read_cost", archive_read_cost);
+                capture_boolean_parameter("defer_archive_only_objects", defer_archive_only_objects);
+                capture_boolean_parameter("execute_near_data", execute_near_data);
+
+                if(cfg.find("index_rate_limits") != cfg.end()) {
+                    using object = std::unordered_map<std::string, boost::any>;
+                    const auto& limits = boost::any_cast<const object&>(cfg.at("index_rate_limits"));
+                    for(const auto& limit : limits) {
+                        const auto& rates = boost::any_cast<const object&>(limit.second);
+                        rate_limit r{};
+                        if(rates.find("documents_per_second") != rates.end()) {
+                            r.documents_per_second = boost::any_cast<int>(rates.at("documents_per_second"));
+                        }
+                        if(rates.find("bytes_per_second") != rates.end()) {
+                            r.bytes_per_second = boost::any_cast<int>(rates.at("bytes_per_second"));
+                        }
+                        index_rate_limits[limit.first] = r;
+                    }
+                }
+
+                // configured costs are merged over the defaults
+                if(cfg.find("replica_read_costs") != cfg.end()) {
+                    using object = std::unordered_map<std::string, boost::any>;
+                    const auto& costs = boost::any_cast<const object&>(cfg.at("replica_read_costs"));
+                    for(const auto& cost : costs) {
+                        replica_read_costs[cost.first] = boost::any_cast<int>(cost.second);
+                    }
+                }
             } catch ( const boost::bad_any_cast& _e ) {
                 THROW( INVALID_ANY_CAST, _e.what() );
             } catch ( const exception _e ) {
@@ -28,6 +111,48 @@ namespace irods {
 
         } // ctor configuration
 
+        std::shared_ptr<const configuration> get_configuration(
+                const std::string& _instance_name) {
+            std::lock_guard<std::mutex> lock{configurations_mutex};
+            auto& snapshot = configurations[_instance_name];
+            if(!snapshot) {
+                snapshot = std::make_shared<const configuration>(_instance_name);
+            }
+
+            return snapshot;
+        } // get_configuration
+
+        std::shared_ptr<const configuration> reload_configuration(
+                const std::string& _instance_name) {
+            // a configuration which fails to parse leaves the previous in place
+            auto snapshot = std::make_shared<const configuration>(_instance_name);
+
+            std::lock_guard<std::mutex> lock{configurations_mutex};
+            configurations[_instance_name] = snapshot;
+            return snapshot;
+        } // reload_configuration
+
+        std::shared_ptr<const configuration> refresh_configuration(
+                const std::string& _instance_name) {
+            auto snapshot = get_configuration(_instance_name);
+            if(get_server_config_modify_time() == snapshot->modify_time_) {
+                return snapshot;
+            }
+
+            try {
+                return reload_configuration(_instance_name);
+            }
+            catch(const irods::exception& _e) {
+                // a file caught mid edit is retried by the next job
+                rodsLog(
+                    LOG_ERROR,
+                    "failed to reload the configuration of [%s] [%s]",
+                    _instance_name.c_str(),
+                    _e.what());
+                return snapshot;
+            }
+        } // refresh_configuration
+
         namespace policy {
             std::string compose_policy_name(
                     const std::string& _prefix,
@@ -62,6 +187,33 @@ namespace irods {
                 % _operation_type
                 % _index_type);
         } // operation_and_index_types_to_policy_name
+
+        std::string operation_and_index_types_to_batch_policy_name(
+                const std::string& _operation_type,
+                const std::string& _index_type) {
+            if(operation_type::index == _operation_type) {
+                if(index_type::full_text == _index_type) {
+                    return policy::object::index_batch;
+                }
+                else if(index_type::metadata == _index_type) {
+                    return policy::metadata::index_batch;
+                }
+            }
+            else if(operation_type::purge == _operation_type) {
+                if(index_type::full_text == _index_type) {
+                    return policy::object::purge_batch;
+                }
+                else if(index_type::metadata == _index_type) {
+                    return policy::metadata::purge_batch;
+                }
+            } // else
+
+            THROW(
+                SYS_INVALID_INPUT_PARAM,
+                boost::format("operation [%s], index [%s]")
+                % _operation_type
+                % _index_type);
+        } // operation_and_index_types_to_batch_policy_name
     } // namespace indexing
 } // namepsace irods
 
@@ -1,6 +1,9 @@
 #ifndef CONFIGURATION_HPP
 #define CONFIGURATION_HPP
 
+#include <ctime>
+#include <map>
+#include <memory>
 #include <string>
 #include "rodsLog.h"
 
@@ -27,24 +30,49 @@ namespace irods {
             namespace object {
                 static const std::string index{"irods_policy_indexing_object_index"};
                 static const std::string purge{"irods_policy_indexing_object_purge"};
+                static const std::string index_batch{"irods_policy_indexing_object_index_batch"};
+                static const std::string purge_batch{"irods_policy_indexing_object_purge_batch"};
+                static const std::string rename{"irods_policy_indexing_object_rename"};
+
+                // one read of an object into several full text indices
+                static const std::string index_multiple{"irods_policy_indexing_object_index_multiple"};
             } // object
 
             namespace metadata {
                 static const std::string index{"irods_policy_indexing_metadata_index"};
                 static const std::string purge{"irods_policy_indexing_metadata_purge"};
+                static const std::string index_batch{"irods_policy_indexing_metadata_index_batch"};
+                static const std::string purge_batch{"irods_policy_indexing_metadata_purge_batch"};
+
+                // the avus added to and removed from an object by one api call
+                static const std::string update{"irods_policy_indexing_metadata_update"};
             } // metadata
 
             namespace collection {
                 static const std::string index{"irods_policy_indexing_collection_index"};
                 static const std::string purge{"irods_policy_indexing_collection_purge"};
+                static const std::string reconcile{"irods_policy_indexing_collection_reconcile"};
+                static const std::string rename{"irods_policy_indexing_collection_rename"};
+
+                // technology policy listing a page of the documents indexed
+                // for the objects within a collection, ordered by data id
+                static const std::string list{"irods_policy_indexing_collection_list"};
             } // collection
 
+            namespace instance {
+                static const std::string reload_configuration{"irods_policy_indexing_instance_reload_configuration"};
+            } // instance
+
         } // policy
 
         std::string operation_and_index_types_to_policy_name(
                 const std::string& _operation_type,
                 const std::string& _index_type);
 
+        std::string operation_and_index_types_to_batch_policy_name(
+                const std::string& _operation_type,
+                const std::string& _index_type);
+
         namespace schedule {
             static const std::string object{"irods_policy_schedule_object_indexing"};
             static const std::string collection{"irods_policy_schedule_collection_indexing"};
@@ -60,6 +88,27 @@ namespace irods {
             static const std::string purge{"purge"};
         }
 
+        namespace execution_mode {
+            static const std::string delay{"delay"};
+            static const std::string worker_pool{"worker_pool"};
+        }
+
+        namespace priority_class {
+            static const std::string metadata{"metadata"};
+            static const std::string small_full_text{"small_full_text"};
+            static const std::string large_full_text{"large_full_text"};
+            static const std::string bulk{"bulk"};
+        }
+
+        // sustained rate at which jobs for an index are started, zero is
+        // unlimited
+        struct rate_limit {
+            int documents_per_second{0};
+            int bytes_per_second{0};
+        }; // struct rate_limit
+
+        static const std::string default_rate_limit{"default"};
+
         struct configuration {
             // metadata attributes
             std::string index{"irods::indexing::index"};
@@ -70,9 +119,94 @@ namespace irods {
             std::string delay_parameters{"<EF>60s DOUBLE UNTIL SUCCESS OR 5 TIMES</EF>"};
             int log_level{LOG_DEBUG};
 
+            // number of objects carried by a single collection batch job
+            int collection_batch_size{100};
+
+            // number of child crawl jobs a collection crawl hands its
+            // subcollections to, zero walks the whole tree in one job
+            int collection_crawl_fan_out{0};
+
+            // number of objects a crawl job visits before it reschedules
+            // itself with a continuation token, zero never checkpoints
+            int collection_crawl_checkpoint_interval{10000};
+
+            // number of indexed documents requested from the technology at
+            // a time while reconciling a collection
+            int reconcile_page_size{1000};
+
+            // lifetime of the cached set of indexing resource names
+            int resource_cache_ttl_in_seconds{300};
+
+            // lifetime of the cached trie of indexed collections
+            int collection_cache_ttl_in_seconds{300};
+
+            // number of object events held by an agent before they are
+            // scheduled together, zero schedules each event immediately
+            int event_buffer_size{0};
+            int event_buffer_flush_interval_in_seconds{5};
+
+            // delay rule priority for each priority class, and the object
+            // size at which full text jobs move to the large lane
+            int metadata_priority{8};
+            int small_full_text_priority{6};
+            int large_full_text_priority{4};
+            int bulk_priority{2};
+            int large_object_size_in_bytes{33554432};
+
+            // jobs are handed to the delay server, or to a pool of worker
+            // threads in the scheduling agent which falls back to the delay
+            // server when its queue is full
+            std::string execution_mode{execution_mode::delay};
+            int worker_thread_count{4};
+            int worker_queue_size{1000};
+
+            // per index rate limits, keyed by index name or default_rate_limit,
+            // which replace the random delay between the minimum and maximum
+            std::map<std::string, rate_limit> index_rate_limits;
+
+            // cost of reading a replica for full text indexing, by resource
+            // type or by a resource avu on read_cost_attribute which takes
+            // precedence, plus remote_replica_cost when the resource is not
+            // local to the server running the job
+            std::map<std::string, int> replica_read_costs{{"univmss", 100}};
+            std::string read_cost_attribute{"irods::indexing::read_cost"};
+            int remote_replica_cost{10};
+
+            // objects whose every good replica costs at least this much to
+            // read are archive only, and are optionally indexed in the bulk
+            // lane
+            int archive_read_cost{100};
+            bool defer_archive_only_objects{false};
+
+            // full text index jobs run on the server hosting the replica they
+            // read, forwarded there by whichever server picks them up
+            bool execute_near_data{false};
+
             const std::string instance_name_{};
+
+            // modification time of server_config.json when it was parsed
+            std::time_t modify_time_{};
+
+            // parsed from server_config.json on disk, which may be newer
+            // than the server properties of a long running process
             explicit configuration(const std::string& _instance_name);
         }; // struct configuration
+
+        // the parsed configuration of an instance, shared by every indexer
+        // within the process until it is replaced by reload_configuration
+        std::shared_ptr<const configuration> get_configuration(
+                const std::string& _instance_name);
+
+        // parse the configuration of an instance again, holders of the
+        // previous snapshot keep it until they release it
+        std::shared_ptr<const configuration> reload_configuration(
+                const std::string& _instance_name);
+
+        // reload the configuration of an instance should server_config.json
+        // have been modified since it was parsed, called as each job starts
+        // so that every process picks up a change
+        std::shared_ptr<const configuration> refresh_configuration(
+                const std::string& _instance_name);
     } // namespace indexing
 } // namespace irods
 
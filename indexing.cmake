@@ -26,6 +26,8 @@ add_library(
     ${CMAKE_SOURCE_DIR}/plugin_specific_configuration.cpp
     ${CMAKE_SOURCE_DIR}/utilities.cpp
     ${CMAKE_SOURCE_DIR}/indexing_utilities.cpp
+    ${CMAKE_SOURCE_DIR}/collection_trie.cpp
+    ${CMAKE_SOURCE_DIR}/worker_pool.cpp
     )
 
 target_include_directories(
@@ -44,6 +46,7 @@ target_link_libraries(
     ${IRODS_PLUGIN_POLICY_LINK_LIBRARIES}
     ${IRODS_EXTERNALS_FULLPATH_BOOST}/lib/libboost_filesystem.so
     irods_common
+    irods_client
     )
 
 target_compile_definitions(${TARGET_NAME} PRIVATE ${IRODS_PLUGIN_POLICY_COMPILE_DEFINITIONS} ${IRODS_COMPILE_DEFINITIONS} BOOST_SYSTEM_NO_DEPRECATED)
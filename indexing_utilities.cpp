@@ -10,7 +10,6 @@
 #include "rsOpenCollection.hpp"
 #include "rsReadCollection.hpp"
 #include "rsCloseCollection.hpp"
-#include "rsModAVUMetadata.hpp"
 
 #define IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
 #include "filesystem.hpp"
@@ -21,7 +20,23 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <atomic>
 #include <random>
+#include <cmath>
+#include <ctime>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+
+#include <unistd.h>
+#include <ifaddrs.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
 
 #include "json.hpp"
 
@@ -32,17 +47,294 @@ int _delayExec(
     const char *delayCondition,
     ruleExecInfo_t *rei );
 
+namespace {
+    struct indexing_resource_cache {
+        std::mutex                                                mutex;
+        std::shared_ptr<const irods::indexing::resource_name_set> names;
+        std::chrono::steady_clock::time_point                     expiration;
+
+        // the type, location and read cost of every resource, by name
+        std::shared_ptr<const irods::indexing::resource_property_map> properties;
+        std::chrono::steady_clock::time_point                         properties_expiration;
+    } resource_cache;
+
+    // a host resolves to the same addresses for at least this long
+    const std::chrono::seconds host_resolution_lifetime{300};
+
+    struct indexed_collection_cache {
+        std::mutex                                        mutex;
+        std::unique_ptr<irods::indexing::collection_trie> trie;
+        std::chrono::steady_clock::time_point             expiration;
+    } collection_cache;
+
+    // the virtual start time of the next job per index, which advances by
+    // the cost of each job scheduled against the index rate limit.  held in
+    // process memory, the catalog is not written as events are scheduled
+    struct index_rate_buckets {
+        std::mutex                    mutex;
+        std::map<std::string, double> next_start;
+    } rate_buckets;
+
+    struct indexing_worker_pool {
+        std::mutex                                    mutex;
+        std::unique_ptr<irods::indexing::worker_pool> pool;
+    } job_workers;
+
+    // set in agents which execute jobs, those a job schedules go to the
+    // delay server rather than to yet another pool of connections
+    std::atomic<bool> worker_pool_disabled{false};
+
+    int get_delay_priority(const std::string& _params) {
+        const auto begin = _params.find("<PRIORITY>");
+        const auto end   = _params.find("</PRIORITY>");
+        if(begin == std::string::npos || end == std::string::npos) {
+            return 0;
+        }
+
+        try {
+            return boost::lexical_cast<int>(
+                       _params.substr(begin + 10, end - begin - 10));
+        }
+        catch(const boost::bad_lexical_cast&) {
+            return 0;
+        }
+    } // get_delay_priority
+
+    // a collection name for use in a like pattern, where it matches only
+    // itself rather than treating an underscore or percent as a wildcard
+    std::string escape_like_wildcards(const std::string& _value) {
+        std::string escaped;
+        for(const auto c : _value) {
+            if('\\' == c || '_' == c || '%' == c) {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+
+        return escaped;
+    } // escape_like_wildcards
+
+    // a like match may still be a sibling should the catalog not honor the
+    // escape, so rows are checked against the collection itself
+    bool collection_is_within(
+        const std::string& _collection_name,
+        const std::string& _parent_name) {
+        return "/" == _parent_name ||
+               _collection_name == _parent_name ||
+               boost::algorithm::starts_with(_collection_name, _parent_name + "/");
+    } // collection_is_within
+
+    // a query condition matching a collection and every collection below it,
+    // the zone root has no separator of its own to append
+    std::string collection_tree_condition(const std::string& _collection_name) {
+        if("/" == _collection_name) {
+            return "COLL_NAME like '/%'";
+        }
+
+        return boost::str(
+                   boost::format("COLL_NAME = '%s' || like '%s/%%'")
+                   % _collection_name
+                   % escape_like_wildcards(_collection_name));
+    } // collection_tree_condition
+} // namespace
+
 namespace irods {
     namespace indexing {
+        void invalidate_indexing_resource_cache() {
+            std::lock_guard<std::mutex> lock{resource_cache.mutex};
+            resource_cache.names.reset();
+            resource_cache.properties.reset();
+        } // invalidate_indexing_resource_cache
+
+        void invalidate_indexed_collection_cache() {
+            std::lock_guard<std::mutex> lock{collection_cache.mutex};
+            collection_cache.trie.reset();
+        } // invalidate_indexed_collection_cache
+
+        void update_indexed_collection_cache(
+            const std::string& _operation,
+            const std::string& _collection_name,
+            const std::string& _value,
+            const std::string& _units) {
+            std::lock_guard<std::mutex> lock{collection_cache.mutex};
+            if(!collection_cache.trie) {
+                return;
+            }
+
+            if("add" == _operation) {
+                collection_cache.trie->insert(_collection_name, _value, _units);
+            }
+            else if("set" == _operation) {
+                collection_cache.trie->erase(_collection_name);
+                collection_cache.trie->insert(_collection_name, _value, _units);
+            }
+            else {
+                // removals match the catalog loosely, reload rather than guess
+                collection_cache.trie.reset();
+            }
+        } // update_indexed_collection_cache
+
+        // a resource location names this server by its full or short host name
+        bool host_is_local(
+            const std::string& _host) {
+            if(_host.empty() || "localhost" == _host) {
+                return true;
+            }
+
+            // resolutions are kept for a while, the lock is not held while
+            // resolving so a slow name server stalls only the caller
+            using resolution = std::pair<bool, std::chrono::steady_clock::time_point>;
+            static std::mutex                        mutex;
+            static std::map<std::string, resolution> resolved;
+            const auto now = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                const auto itr = resolved.find(_host);
+                if(itr != resolved.end() && now < itr->second.second) {
+                    return itr->second.first;
+                }
+            }
+
+            // a host is local when any address it resolves to belongs to an
+            // interface of this server, rather than by comparing names
+            std::set<std::string> local_addresses;
+            ifaddrs* interfaces{};
+            if(0 == getifaddrs(&interfaces)) {
+                for(auto i = interfaces; i; i = i->ifa_next) {
+                    if(!i->ifa_addr ||
+                       (AF_INET != i->ifa_addr->sa_family && AF_INET6 != i->ifa_addr->sa_family)) {
+                        continue;
+                    }
+
+                    char address[NI_MAXHOST]{};
+                    const auto length = AF_INET == i->ifa_addr->sa_family ? sizeof(sockaddr_in) : sizeof(sockaddr_in6);
+                    if(0 == getnameinfo(i->ifa_addr, length, address, sizeof(address), nullptr, 0, NI_NUMERICHOST)) {
+                        local_addresses.insert(address);
+                    }
+                }
+                freeifaddrs(interfaces);
+            }
+
+            bool local{false};
+            addrinfo hints{};
+            hints.ai_family   = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo* results{};
+            if(0 == getaddrinfo(_host.c_str(), nullptr, &hints, &results)) {
+                for(auto r = results; r && !local; r = r->ai_next) {
+                    char address[NI_MAXHOST]{};
+                    if(0 == getnameinfo(r->ai_addr, r->ai_addrlen, address, sizeof(address), nullptr, 0, NI_NUMERICHOST)) {
+                        local = local_addresses.count(address) > 0;
+                    }
+                }
+                freeaddrinfo(results);
+            }
+            else {
+                // an unresolvable host may still name this server exactly
+                char name[256]{};
+                gethostname(name, sizeof(name) - 1);
+                local = boost::iequals(_host, name);
+            }
+
+            std::lock_guard<std::mutex> lock{mutex};
+            resolved[_host] = resolution{local, now + host_resolution_lifetime};
+            return local;
+        } // host_is_local
+
+        void disable_worker_pool() {
+            worker_pool_disabled = true;
+        } // disable_worker_pool
+
+        std::vector<pending_job> stop_worker_pool() {
+            std::unique_ptr<irods::indexing::worker_pool> pool;
+            {
+                std::lock_guard<std::mutex> lock{job_workers.mutex};
+                pool = std::move(job_workers.pool);
+            }
+
+            if(!pool) {
+                return {};
+            }
+
+            return pool->stop();
+        } // stop_worker_pool
+
         indexer::indexer(
             ruleExecInfo_t*    _rei,
             const std::string& _instance_name) :
               rei_(_rei)
             , comm_(_rei->rsComm)
-            , config_(_instance_name) {
+            , config_(get_configuration(_instance_name)) {
         } // indexer
 
         void indexer::schedule_indexing_policy(
+            const std::string& _json,
+            const std::string& _params) {
+            if(execution_mode::worker_pool != config_->execution_mode ||
+               worker_pool_disabled ||
+               job_is_rate_limited(_json)) {
+                schedule_delayed_indexing_policy(_json, _params);
+                return;
+            }
+
+            std::vector<pending_job> returned_jobs;
+            bool submitted{};
+            {
+                std::lock_guard<std::mutex> lock{job_workers.mutex};
+                if(!job_workers.pool) {
+                    job_workers.pool = std::make_unique<irods::indexing::worker_pool>(
+                                           config_->instance_name_,
+                                           config_->worker_thread_count,
+                                           config_->worker_queue_size);
+                }
+
+                returned_jobs = job_workers.pool->take_returned_jobs();
+                submitted     = job_workers.pool->try_submit(
+                                    pending_job{_json, _params, get_delay_priority(_params)});
+            }
+
+            // jobs the workers could not run are handed over while we hold a
+            // connection capable of doing so
+            for(const auto& job : returned_jobs) {
+                schedule_delayed_indexing_policy(job.rule_text, job.delay_parameters);
+            }
+
+            if(!submitted) {
+                rodsLog(
+                    config_->log_level,
+                    "irods::indexing worker queue is full, scheduling on the delay server");
+                schedule_delayed_indexing_policy(_json, _params);
+            }
+        } // schedule_indexing_policy
+
+        bool indexer::job_is_rate_limited(
+            const std::string& _json) {
+            if(config_->index_rate_limits.empty()) {
+                return false;
+            }
+
+            // a limited index holds its jobs until their reserved start time,
+            // which only the delay server observes
+            try {
+                const auto rule_obj = nlohmann::json::parse(_json);
+                auto index_names = rule_obj.value("index-names", std::vector<std::string>{});
+                if(rule_obj.find("index-name") != rule_obj.end()) {
+                    index_names.push_back(rule_obj.at("index-name").get<std::string>());
+                }
+
+                const auto& limits = config_->index_rate_limits;
+                return limits.find(default_rate_limit) != limits.end() ||
+                       std::any_of(
+                           index_names.begin(),
+                           index_names.end(),
+                           [&limits](const std::string& _n) { return limits.find(_n) != limits.end(); });
+            }
+            catch(const std::exception&) {
+                return false;
+            }
+        } // job_is_rate_limited
+
+        void indexer::schedule_delayed_indexing_policy(
             const std::string& _json,
             const std::string& _params) {
             const int delay_err = _delayExec(
@@ -55,7 +347,7 @@ namespace irods {
                 delay_err,
                 "delayExec failed");
             }
-        } // schedule_indexing_policy
+        } // schedule_delayed_indexing_policy
 
         bool indexer::metadata_exists_on_collection(
             const std::string& _collection_name,
@@ -96,7 +388,7 @@ namespace irods {
             const std::string& _indexer) {
 
         rodsLog(
-            config_.log_level,
+            config_->log_level,
             "irods::indexing::collection indexing collection [%s] with [%s] type [%s]",
             _collection_name.c_str(),
             _indexer_string.c_str(),
@@ -110,21 +402,26 @@ namespace irods {
             using json = nlohmann::json;
             json rule_obj;
             rule_obj["rule-engine-operation"]     = policy_name;
-            rule_obj["rule-engine-instance-name"] = config_.instance_name_;
+            rule_obj["rule-engine-instance-name"] = config_->instance_name_;
             rule_obj["collection-name"]           = _collection_name;
             rule_obj["user-name"]                 = _user_name;
             rule_obj["indexer"]                   = _indexer;
             rule_obj["index-name"]                = index_name;
             rule_obj["index-type"]                = index_type;
+            rule_obj["priority-class"]            = priority_class::bulk;
 
-            const auto delay_err = _delayExec(
-                                       rule_obj.dump().c_str(),
-                                       "",
-                                       generate_delay_execution_parameters().c_str(),
-                                       rei_);
-            if(delay_err < 0) {
+            try {
+                schedule_indexing_policy(
+                    rule_obj.dump(),
+                    generate_delay_execution_parameters(
+                        priority_class::bulk,
+                        index_name,
+                        0,
+                        0));
+            }
+            catch(const irods::exception& _e) {
                 THROW(
-                    delay_err,
+                    _e.code(),
                     boost::format("queue collection indexing failed for [%s] indexer [%s] type [%s]") %
                     _collection_name %
                     _indexer %
@@ -132,157 +429,1101 @@ namespace irods {
             }
 
         rodsLog(
-            config_.log_level,
+            config_->log_level,
             "irods::indexing::collection indexing collection [%s] with [%s] type [%s]",
             _collection_name.c_str(),
             _indexer.c_str(),
             index_type.c_str());
         } // schedule_collection_operation
 
-        std::vector<std::string> indexer::get_indexing_resource_names() {
+        void indexer::schedule_registered_collection(
+            const std::string& _collection_name,
+            const std::string& _user_name) {
+            // newly registered objects carry no metadata, only full text
+            // indices have anything to crawl for
+            for(const auto& row : get_index_metadata_for_path(_collection_name)) {
+                const auto& indexer_string = row.first;
+                const auto& indexer = row.second;
+                std::string index_name, index_type;
+                try {
+                    std::tie(index_name, index_type) = parse_indexer_string(indexer_string);
+                }
+                catch(const irods::exception&) {
+                    continue;
+                }
+
+                if(irods::indexing::index_type::full_text != index_type) {
+                    continue;
+                }
+
+                schedule_collection_operation(
+                    irods::indexing::operation_type::index,
+                    _collection_name,
+                    _user_name,
+                    indexer_string,
+                    indexer);
+            } // for row
+        } // schedule_registered_collection
+
+        void indexer::purge_collections(
+            const std::vector<std::string>& _collection_names,
+            const std::string&              _user_name,
+            const std::string&              _indexer,
+            const std::string&              _index_name,
+            const std::string&              _index_type,
+            const std::string&              _continuation_token) {
+            const auto policy_name = policy::compose_policy_name(
+                                         policy::collection::purge,
+                                         _indexer);
+
+            // a crawl already under way is finished as it began
+            if(!_continuation_token.empty() || !policy_exists(rei_, policy_name)) {
+                schedule_policy_events_for_collection(
+                    irods::indexing::operation_type::purge,
+                    _collection_names,
+                    _user_name,
+                    _indexer,
+                    _index_name,
+                    _index_type,
+                    _continuation_token);
+                return;
+            }
+
+            for(const auto& collection_name : _collection_names) {
+                std::list<boost::any> args;
+                args.push_back(boost::any(collection_name));
+                args.push_back(boost::any(_index_name));
+                args.push_back(boost::any(_index_type));
+                invoke_policy(rei_, policy_name, args);
+
+                rodsLog(
+                    config_->log_level,
+                    "irods::indexing::indexer purged collection [%s] from [%s] type [%s]",
+                    collection_name.c_str(),
+                    _index_name.c_str(),
+                    _index_type.c_str());
+            }
+        } // purge_collections
+
+        bool indexer::object_has_indexed_replica(
+            const std::string& _object_path,
+            const std::string& _resource_name) {
+            using fsp = irods::experimental::filesystem::path;
+
+            fsp path{_object_path};
+            std::string query_str {
+                boost::str(
+                        boost::format("SELECT RESC_NAME WHERE COLL_NAME = '%s' AND DATA_NAME = '%s' AND DATA_REPL_STATUS = '1'")
+                        % path.parent_path().string()
+                        % path.object_name().string())};
+
+            const auto indexing_resources = get_indexing_resource_names();
+            query<rsComm_t> qobj{comm_, query_str};
+            for(const auto& row : qobj) {
+                if(row[0] != _resource_name &&
+                   resource_is_indexable(row[0], *indexing_resources)) {
+                    return true;
+                }
+            }
+
+            return false;
+        } // object_has_indexed_replica
+
+        replica_read_cost indexer::select_replica_for_reading(
+            const std::string& _object_path) {
+            replica_read_cost ret_val{};
+            int lowest_cost{};
+            for(const auto& r : get_replica_read_costs(_object_path)) {
+                const int cost = r.resource_cost + (r.remote ? config_->remote_replica_cost : 0);
+                if(ret_val.replica_number < 0 || cost < lowest_cost) {
+                    ret_val     = r;
+                    lowest_cost = cost;
+                }
+            }
+
+            return ret_val;
+        } // select_replica_for_reading
+
+        std::string indexer::get_execution_host_for_object(
+            const std::string& _object_path) {
+            const replica_read_cost* cheapest{};
+            const auto costs = get_replica_read_costs(_object_path);
+            for(const auto& r : costs) {
+                if(!cheapest || r.resource_cost < cheapest->resource_cost) {
+                    cheapest = &r;
+                }
+            }
+
+            // coordinating resources have no host of their own
+            if(!cheapest || "EMPTY_RESC_HOST" == cheapest->host) {
+                return {};
+            }
+
+            return cheapest->host;
+        } // get_execution_host_for_object
+
+        std::vector<replica_read_cost> indexer::get_replica_read_costs(
+            const std::string& _object_path) {
+            using fsp = irods::experimental::filesystem::path;
+
+            fsp path{_object_path};
+            std::string query_str {
+                boost::str(
+                        boost::format("SELECT DATA_REPL_NUM, RESC_NAME, DATA_SIZE WHERE COLL_NAME = '%s' AND DATA_NAME = '%s' AND DATA_REPL_STATUS = '1'")
+                        % path.parent_path().string()
+                        % path.object_name().string())};
+
+            auto properties = get_resource_properties();
+
+            std::vector<replica_read_cost> ret_val;
+            query<rsComm_t> qobj{comm_, query_str};
+            for(const auto& row : qobj) {
+                replica_read_cost r{};
+                try {
+                    r.replica_number = boost::lexical_cast<int>(row[0]);
+                }
+                catch(const boost::bad_lexical_cast&) {
+                    continue;
+                }
+
+                // a resource created since the cache was loaded reloads it
+                auto resource = properties->find(row[1]);
+                if(resource == properties->end()) {
+                    invalidate_indexing_resource_cache();
+                    properties = get_resource_properties();
+                    resource   = properties->find(row[1]);
+                }
+
+                if(resource != properties->end()) {
+                    const auto& p = resource->second;
+                    if(p.has_read_cost) {
+                        r.resource_cost = p.read_cost;
+                    }
+                    else {
+                        const auto type_cost = config_->replica_read_costs.find(p.type);
+                        if(type_cost != config_->replica_read_costs.end()) {
+                            r.resource_cost = type_cost->second;
+                        }
+                    }
+
+                    r.remote = !host_is_local(p.location);
+                    r.host   = p.location;
+                }
+
+                try {
+                    r.data_size = boost::lexical_cast<rodsLong_t>(row[2]);
+                }
+                catch(const boost::bad_lexical_cast&) {}
+
+                ret_val.push_back(r);
+            } // for row
+
+            // ties go to the lowest replica number
+            std::sort(
+                ret_val.begin(),
+                ret_val.end(),
+                [](const replica_read_cost& _l, const replica_read_cost& _r) {
+                    return _l.replica_number < _r.replica_number;
+                });
+
+            return ret_val;
+        } // get_replica_read_costs
+
+        bool indexer::object_is_archive_only(
+            const std::string& _object_path) {
+            const auto costs = get_replica_read_costs(_object_path);
+            return !costs.empty() &&
+                   std::all_of(
+                       costs.begin(),
+                       costs.end(),
+                       [this](const replica_read_cost& _r) {
+                           return _r.resource_cost >= config_->archive_read_cost;
+                       });
+        } // object_is_archive_only
+
+        std::shared_ptr<const resource_property_map> indexer::get_resource_properties() {
+            const auto now = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lock{resource_cache.mutex};
+                if(resource_cache.properties && now < resource_cache.properties_expiration) {
+                    return resource_cache.properties;
+                }
+            }
+
+            auto ret_val = std::make_shared<resource_property_map>();
+            query<rsComm_t> resources{comm_, "SELECT RESC_NAME, RESC_TYPE_NAME, RESC_LOC"};
+            for(const auto& row : resources) {
+                auto& p    = (*ret_val)[row[0]];
+                p.type     = row[1];
+                p.location = row[2];
+            }
+
+            std::string query_str {
+                boost::str(
+                        boost::format("SELECT RESC_NAME, META_RESC_ATTR_VALUE WHERE META_RESC_ATTR_NAME = '%s'")
+                        % config_->read_cost_attribute)};
+            query<rsComm_t> hints{comm_, query_str};
+            for(const auto& row : hints) {
+                try {
+                    auto& p         = (*ret_val)[row[0]];
+                    p.read_cost     = boost::lexical_cast<int>(row[1]);
+                    p.has_read_cost = true;
+                }
+                catch(const boost::bad_lexical_cast&) {
+                    rodsLog(
+                        LOG_ERROR,
+                        "invalid read cost [%s] for resource [%s]",
+                        row[1].c_str(),
+                        row[0].c_str());
+                }
+            }
+
+            std::lock_guard<std::mutex> lock{resource_cache.mutex};
+            resource_cache.properties            = ret_val;
+            resource_cache.properties_expiration = now + std::chrono::seconds(config_->resource_cache_ttl_in_seconds);
+
+            return ret_val;
+        } // get_resource_properties
+
+        void indexer::schedule_metadata_update(
+            const std::string&      _object_path,
+            const std::string&      _user_name,
+            const std::vector<avu>& _added,
+            const std::vector<avu>& _removed) {
+            if(_added.empty() && _removed.empty()) {
+                return;
+            }
+
+            for(const auto& target : get_index_targets_for_object(_object_path, index_type::metadata)) {
+                schedule_metadata_update_policy(
+                    _object_path,
+                    _user_name,
+                    target.indexer,
+                    target.index_name,
+                    _added,
+                    _removed);
+            }
+        } // schedule_metadata_update
+
+        void indexer::schedule_metadata_update_policy(
+            const std::string&      _object_path,
+            const std::string&      _user_name,
+            const std::string&      _indexer,
+            const std::string&      _index_name,
+            const std::vector<avu>& _added,
+            const std::vector<avu>& _removed) {
+            using json = nlohmann::json;
+            json rule_obj;
+            rule_obj["rule-engine-operation"]     = policy::metadata::update;
+            rule_obj["rule-engine-instance-name"] = config_->instance_name_;
+            rule_obj["object-path"]               = _object_path;
+            rule_obj["user-name"]                 = _user_name;
+            rule_obj["indexer"]                   = _indexer;
+            rule_obj["index-name"]                = _index_name;
+            rule_obj["index-type"]                = index_type::metadata;
+            rule_obj["avus-added"]                = _added;
+            rule_obj["avus-removed"]              = _removed;
+            rule_obj["priority-class"]            = priority_class::metadata;
+
+            // split as object batches are, the added and removed avus are
+            // disjoint so the resulting jobs may run in any order
+            const auto rule_text = rule_obj.dump();
+            if(rule_text.size() + sizeof("@external\n") > META_STR_LEN &&
+               _added.size() + _removed.size() > 1) {
+                const auto& larger  = _added.size() >= _removed.size() ? _added : _removed;
+                const auto  middle  = larger.begin() + larger.size() / 2;
+                const std::vector<avu> first(larger.begin(), middle);
+                const std::vector<avu> second(middle, larger.end());
+                const bool  added   = &larger == &_added;
+                schedule_metadata_update_policy(
+                    _object_path,
+                    _user_name,
+                    _indexer,
+                    _index_name,
+                    added ? first : _added,
+                    added ? _removed : first);
+                schedule_metadata_update_policy(
+                    _object_path,
+                    _user_name,
+                    _indexer,
+                    _index_name,
+                    added ? second : std::vector<avu>{},
+                    added ? std::vector<avu>{} : second);
+                return;
+            }
+
+            schedule_indexing_policy(
+                rule_text,
+                generate_delay_execution_parameters(
+                    priority_class::metadata,
+                    _index_name,
+                    _added.size() + _removed.size(),
+                    0));
+
+            rodsLog(
+                config_->log_level,
+                "irods::indexing::indexer scheduled [%d] added and [%d] removed avus for [%s] in [%s]",
+                static_cast<int>(_added.size()),
+                static_cast<int>(_removed.size()),
+                _object_path.c_str(),
+                _index_name.c_str());
+        } // schedule_metadata_update_policy
+
+        void indexer::schedule_rename(
+            const std::string& _source_path,
+            const std::string& _destination_path,
+            bool               _is_collection,
+            const std::string& _user_name) {
+            using fsp = irods::experimental::filesystem::path;
+
+            // the catalog already holds the new paths, annotations on the
+            // renamed collection and within it have travelled with it while
+            // those above either location are found by the parent collection
+            auto source_metadata      = get_index_metadata_for_path(fsp{_source_path}.parent_path().string());
+            auto destination_metadata = get_index_metadata_for_path(fsp{_destination_path}.parent_path().string());
+            if(_is_collection) {
+                const auto moved = query_indexed_collections(
+                                       [&_destination_path](const collection_trie& _trie) {
+                                           return _trie.metadata_within_path(_destination_path);
+                                       });
+                source_metadata.insert(source_metadata.end(), moved.begin(), moved.end());
+                destination_metadata.insert(destination_metadata.end(), moved.begin(), moved.end());
+            }
+
+            using target = std::tuple<std::string, std::string, std::string>;
+            auto to_targets = [this](const metadata_results& _metadata) {
+                std::set<target> ret_val;
+                for(const auto& row : _metadata) {
+                    std::string index_name, index_type;
+                    try {
+                        std::tie(index_name, index_type) = parse_indexer_string(row.first);
+                    }
+                    catch(const irods::exception&) {
+                        continue;
+                    }
+
+                    ret_val.insert(std::make_tuple(row.second, index_name, index_type));
+                }
+
+                return ret_val;
+            }; // to_targets
+
+            const auto source_targets      = to_targets(source_metadata);
+            const auto destination_targets = to_targets(destination_metadata);
+            const auto& rename_policy      = _is_collection ?
+                                             policy::collection::rename :
+                                             policy::object::rename;
+
+            // documents are renamed in place, those moved out of an index are
+            // then purged by their new path
+            for(const auto& t : source_targets) {
+                schedule_rename_policy(
+                    rename_policy,
+                    _source_path,
+                    _destination_path,
+                    _user_name,
+                    std::get<0>(t),
+                    std::get<1>(t),
+                    std::get<2>(t),
+                    destination_targets.count(t) == 0);
+            }
+
+            for(const auto& t : destination_targets) {
+                if(source_targets.count(t) > 0) {
+                    continue;
+                }
+
+                const auto& indexer    = std::get<0>(t);
+                const auto& index_name = std::get<1>(t);
+                const auto& index_type = std::get<2>(t);
+                if(_is_collection) {
+                    schedule_collection_operation(
+                        irods::indexing::operation_type::index,
+                        _destination_path,
+                        _user_name,
+                        index_name + indexer_separator + index_type,
+                        indexer);
+                    continue;
+                }
+
+                const bool reads_data = irods::indexing::index_type::full_text == index_type;
+                const rodsLong_t byte_count = reads_data ?
+                                              std::max<rodsLong_t>(0, get_data_size_for_object(_destination_path)) :
+                                              0;
+                const auto priority = get_priority_class(
+                                          irods::indexing::operation_type::index,
+                                          index_type,
+                                          byte_count,
+                                          {_destination_path});
+                schedule_policy_event_for_object(
+                    operation_and_index_types_to_policy_name(
+                        irods::indexing::operation_type::index,
+                        index_type),
+                    _destination_path,
+                    _user_name,
+                    EMPTY_RESOURCE_NAME,
+                    indexer,
+                    index_name,
+                    index_type,
+                    priority,
+                    generate_delay_execution_parameters(
+                        priority,
+                        index_name,
+                        1,
+                        byte_count));
+            } // for t
+        } // schedule_rename
+
+        void indexer::schedule_rename_policy(
+            const std::string& _policy_name,
+            const std::string& _source_path,
+            const std::string& _destination_path,
+            const std::string& _user_name,
+            const std::string& _indexer,
+            const std::string& _index_name,
+            const std::string& _index_type,
+            bool               _purge_destination) {
+            // a rename reads no data, an object rename is as cheap as a
+            // metadata job while a collection may rewrite many documents
+            const auto& priority = _policy_name == policy::collection::rename ?
+                                   priority_class::bulk :
+                                   priority_class::metadata;
+
+            using json = nlohmann::json;
+            json rule_obj;
+            rule_obj["rule-engine-operation"]     = _policy_name;
+            rule_obj["rule-engine-instance-name"] = config_->instance_name_;
+            rule_obj["source-path"]               = _source_path;
+            rule_obj["destination-path"]          = _destination_path;
+            rule_obj["user-name"]                 = _user_name;
+            rule_obj["indexer"]                   = _indexer;
+            rule_obj["index-name"]                = _index_name;
+            rule_obj["index-type"]                = _index_type;
+            rule_obj["purge-destination"]         = _purge_destination;
+            rule_obj["priority-class"]            = priority;
+
+            schedule_indexing_policy(
+                rule_obj.dump(),
+                generate_delay_execution_parameters(
+                    priority,
+                    _index_name,
+                    1,
+                    0));
+
+            rodsLog(
+                config_->log_level,
+                "irods::indexing::indexer scheduled rename of [%s] to [%s] in [%s] type [%s]",
+                _source_path.c_str(),
+                _destination_path.c_str(),
+                _index_name.c_str(),
+                _index_type.c_str());
+        } // schedule_rename_policy
+
+        std::shared_ptr<const resource_name_set> indexer::get_indexing_resource_names() {
+            const auto now = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lock{resource_cache.mutex};
+                if(resource_cache.names && now < resource_cache.expiration) {
+                    return resource_cache.names;
+                }
+            }
+
             std::string query_str {
                 boost::str(
                         boost::format("SELECT RESC_NAME WHERE META_RESC_ATTR_NAME = '%s' AND META_RESC_ATTR_VALUE = 'true'")
-                        % config_.index)};
+                        % config_->index)};
 
             query<rsComm_t> qobj{comm_, query_str};
-            std::vector<std::string> ret_val;
+            auto ret_val = std::make_shared<resource_name_set>();
             for(const auto& row : qobj) {
-                ret_val.push_back(row[0]);
+                ret_val->insert(row[0]);
             }
 
+            std::lock_guard<std::mutex> lock{resource_cache.mutex};
+            resource_cache.names      = ret_val;
+            resource_cache.expiration = now + std::chrono::seconds(config_->resource_cache_ttl_in_seconds);
+
             return ret_val;
 
         } // get_indexing_resource_names
 
-        std::string indexer::get_indexing_resource_name_for_object(
-                const std::string        _object_path,
-                std::vector<std::string> _resource_names) {
-            boost::filesystem::path p{_object_path};
-            std::string coll_name = p.parent_path().string();
-            std::string data_name = p.filename().string();
+        bool indexer::resource_is_indexable(
+                const std::string&       _source_resource,
+                const resource_name_set& _resource_names) {
+            return _source_resource == EMPTY_RESOURCE_NAME ||
+                   _resource_names.empty() ||
+                   _resource_names.count(_source_resource) > 0;
+        } // resource_is_indexable
+
+        std::tuple<std::string, std::string>
+        indexer::parse_indexer_string(
+            const std::string& _indexer_string) {
+
+            const auto pos = _indexer_string.find_last_of(indexer_separator);
+            if(std::string::npos == pos) {
+                THROW(
+                   SYS_INVALID_INPUT_PARAM,
+                   boost::format("[%s] does not include an index separator for collection")
+                   % _indexer_string);
+            }
+            const auto index_name = _indexer_string.substr(0, pos-(indexer_separator.size()-1));
+            const auto index_type = _indexer_string.substr(pos+1);
+            return std::make_tuple(index_name, index_type);
+        }
+
+        void indexer::schedule_policy_events_for_collection(
+            const std::string&              _operation_type,
+            const std::vector<std::string>& _collection_names,
+            const std::string&              _user_name,
+            const std::string&              _indexer,
+            const std::string&              _index_name,
+            const std::string&              _index_type,
+            const std::string&              _continuation_token) {
+            // with a fan out each job crawls only its own collections and hands
+            // the subcollections to further jobs, otherwise one job walks the tree.
+            // a continued crawl has already handed off its subcollections
+            const bool fan_out = config_->collection_crawl_fan_out > 0;
+            if(fan_out && _continuation_token.empty()) {
+                schedule_subcollection_crawls(
+                    _operation_type,
+                    _collection_names,
+                    _user_name,
+                    _indexer,
+                    _index_name,
+                    _index_type);
+            }
+
+            const auto start_time = std::chrono::steady_clock::now();
+            const auto object_limit = static_cast<std::size_t>(
+                                          std::max(0, config_->collection_crawl_checkpoint_interval));
+            std::size_t object_count{};
+            std::size_t visited_count{};
+            for(std::size_t i = 0; i < _collection_names.size(); ++i) {
+                std::string last_data_id{0 == i ? _continuation_token : std::string{}};
+                const bool complete = (0 == object_limit || visited_count < object_limit) &&
+                                      schedule_policy_events_for_collection_objects(
+                                          _operation_type,
+                                          _collection_names[i],
+                                          !fan_out,
+                                          _user_name,
+                                          _indexer,
+                                          _index_name,
+                                          _index_type,
+                                          object_limit > 0 ? object_limit - visited_count : 0,
+                                          last_data_id,
+                                          object_count,
+                                          visited_count);
+                if(!complete) {
+                    // persist progress as a new crawl starting from this point,
+                    // data ids are positive so a token of zero starts from the top
+                    if(last_data_id.empty()) {
+                        last_data_id = "0";
+                    }
+
+                    schedule_collection_crawl(
+                        _operation_type,
+                        std::vector<std::string>(_collection_names.begin() + i, _collection_names.end()),
+                        _user_name,
+                        _indexer,
+                        _index_name,
+                        _index_type,
+                        last_data_id);
+
+                    rodsLog(
+                        LOG_NOTICE,
+                        "irods::indexing::indexer checkpoint of crawl of [%s] index [%s] type [%s] after [%d] objects, continuing after data id [%s]",
+                        _collection_names[i].c_str(),
+                        _index_name.c_str(),
+                        _index_type.c_str(),
+                        static_cast<int>(visited_count),
+                        last_data_id.c_str());
+                    break;
+                }
+            } // for i
+
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+            rodsLog(
+                config_->log_level,
+                "irods::indexing::indexer scheduled [%d] objects in [%d] collections starting at [%s] in [%f] seconds - [%f] objects per second",
+                static_cast<int>(object_count),
+                static_cast<int>(_collection_names.size()),
+                _collection_names.empty() ? "" : _collection_names.front().c_str(),
+                elapsed.count(),
+                elapsed.count() > 0 ? object_count / elapsed.count() : 0.0);
+        } // schedule_policy_events_for_collection
+
+        void indexer::schedule_subcollection_crawls(
+            const std::string&              _operation_type,
+            const std::vector<std::string>& _collection_names,
+            const std::string&              _user_name,
+            const std::string&              _indexer,
+            const std::string&              _index_name,
+            const std::string&              _index_type) {
+            std::vector<std::string> subcollections;
+            for(const auto& collection_name : _collection_names) {
+                std::string query_str {
+                    boost::str(
+                            boost::format("SELECT COLL_NAME WHERE COLL_PARENT_NAME = '%s'")
+                            % collection_name)};
+                query<rsComm_t> qobj{comm_, query_str};
+                for(const auto& row : qobj) {
+                    // the root collection is its own parent
+                    if(row[0] != collection_name) {
+                        subcollections.push_back(row[0]);
+                    }
+                }
+            } // for collection_name
+
+            if(subcollections.empty()) {
+                return;
+            }
+
+            // deal the subcollections across at most the fan out number of jobs
+            const auto width = std::min(
+                                   subcollections.size(),
+                                   static_cast<std::size_t>(config_->collection_crawl_fan_out));
+            std::vector<std::vector<std::string>> groups(width);
+            for(std::size_t i = 0; i < subcollections.size(); ++i) {
+                groups[i % width].push_back(subcollections[i]);
+            }
+
+            for(const auto& group : groups) {
+                schedule_collection_crawl(
+                    _operation_type,
+                    group,
+                    _user_name,
+                    _indexer,
+                    _index_name,
+                    _index_type,
+                    {});
+            }
+        } // schedule_subcollection_crawls
+
+        void indexer::schedule_collection_crawl(
+            const std::string&              _operation_type,
+            const std::vector<std::string>& _collection_names,
+            const std::string&              _user_name,
+            const std::string&              _indexer,
+            const std::string&              _index_name,
+            const std::string&              _index_type,
+            const std::string&              _continuation_token) {
+            const auto policy_name = _operation_type == irods::indexing::operation_type::index ?
+                                    irods::indexing::policy::collection::index :
+                                    irods::indexing::policy::collection::purge;
+            using json = nlohmann::json;
+            json rule_obj;
+            rule_obj["rule-engine-operation"]     = policy_name;
+            rule_obj["rule-engine-instance-name"] = config_->instance_name_;
+            rule_obj["collection-names"]          = _collection_names;
+            rule_obj["user-name"]                 = _user_name;
+            rule_obj["indexer"]                   = _indexer;
+            rule_obj["index-name"]                = _index_name;
+            rule_obj["index-type"]                = _index_type;
+            rule_obj["priority-class"]            = priority_class::bulk;
+            if(!_continuation_token.empty()) {
+                rule_obj["continuation-token"]    = _continuation_token;
+            }
+
+            // split crawls whose rule text would not fit in META_STR_LEN, the
+            // continuation belongs to the first collection only
+            const auto rule_text = rule_obj.dump();
+            if(rule_text.size() + sizeof("@external\n") > META_STR_LEN &&
+               _collection_names.size() > 1) {
+                const auto middle = _collection_names.begin() + _collection_names.size() / 2;
+                schedule_collection_crawl(
+                    _operation_type,
+                    std::vector<std::string>(_collection_names.begin(), middle),
+                    _user_name,
+                    _indexer,
+                    _index_name,
+                    _index_type,
+                    _continuation_token);
+                schedule_collection_crawl(
+                    _operation_type,
+                    std::vector<std::string>(middle, _collection_names.end()),
+                    _user_name,
+                    _indexer,
+                    _index_name,
+                    _index_type,
+                    {});
+                return;
+            }
+
+            try {
+                schedule_indexing_policy(
+                    rule_text,
+                    generate_delay_execution_parameters(
+                        priority_class::bulk,
+                        _index_name,
+                        0,
+                        0));
+            }
+            catch(const irods::exception& _e) {
+                THROW(
+                    _e.code(),
+                    boost::format("queue crawl of [%d] collections failed indexer [%s] type [%s]") %
+                    _collection_names.size() %
+                    _indexer %
+                    _index_type);
+            }
+        } // schedule_collection_crawl
+
+        bool indexer::schedule_policy_events_for_collection_objects(
+            const std::string& _operation_type,
+            const std::string& _collection_name,
+            bool               _recursive,
+            const std::string& _user_name,
+            const std::string& _indexer,
+            const std::string& _index_name,
+            const std::string& _index_type,
+            std::size_t        _object_limit,
+            std::string&       _last_data_id,
+            std::size_t&       _object_count,
+            std::size_t&       _visited_count) {
+            const auto indexing_resources = get_indexing_resource_names();
+            const auto policy_name = operation_and_index_types_to_batch_policy_name(
+                                         _operation_type,
+                                         _index_type);
+
+            auto& object_count = _object_count;
+
+            std::vector<std::string> batch;
+            rodsLong_t               batch_bytes{};
+            auto schedule_batch = [&]() {
+                if(batch.empty()) {
+                    return;
+                }
+
+                schedule_policy_event_for_objects(
+                    policy_name,
+                    batch,
+                    _user_name,
+                    EMPTY_RESOURCE_NAME,
+                    _indexer,
+                    _index_name,
+                    _index_type,
+                    priority_class::bulk,
+                    generate_delay_execution_parameters(
+                        priority_class::bulk,
+                        _index_name,
+                        batch.size(),
+                        batch_bytes));
+                object_count += batch.size();
+                batch.clear();
+                batch_bytes = 0;
+            }; // schedule_batch
+
+            // a single paged query over the collection, or the whole tree, one row
+            // per replica ordered by data id so that the replicas of an object
+            // arrive together
+            std::string query_str {
+                _recursive ?
+                "SELECT COLL_NAME, DATA_NAME, ORDER(DATA_ID), RESC_NAME, DATA_SIZE WHERE " +
+                collection_tree_condition(_collection_name) :
+                boost::str(
+                        boost::format("SELECT COLL_NAME, DATA_NAME, ORDER(DATA_ID), RESC_NAME, DATA_SIZE WHERE COLL_NAME = '%s'")
+                        % _collection_name)};
+
+            // resume after the last object of a previous run of this crawl
+            if(!_last_data_id.empty()) {
+                query_str += " AND DATA_ID > '" + _last_data_id + "'";
+            }
+
+            std::string current_data_id;
+            std::string current_path;
+            rodsLong_t  current_size{};
+            bool        current_indexable{false};
+            auto process_object = [&]() {
+                if(current_data_id.empty()) {
+                    return;
+                }
+
+                if(current_indexable) {
+                    batch.push_back(current_path);
+                    if(operation_type::index == _operation_type &&
+                       index_type::full_text == _index_type) {
+                        batch_bytes += current_size;
+                    }
+                    if(batch.size() >= static_cast<std::size_t>(config_->collection_batch_size)) {
+                        schedule_batch();
+                    }
+                }
+                else {
+                    rodsLog(
+                        LOG_ERROR,
+                        "failed to find indexing resource for object [%s]",
+                        current_path.c_str());
+                }
+            }; // process_object
+
+            // true once the object limit is reached
+            std::size_t visited_count{};
+            auto finish_object = [&]() {
+                if(current_data_id.empty()) {
+                    return false;
+                }
+
+                process_object();
+                _last_data_id = current_data_id;
+                current_data_id.clear();
+                ++visited_count;
+                ++_visited_count;
+                return _object_limit > 0 && visited_count >= _object_limit;
+            }; // finish_object
+
+            bool complete{true};
+            query<rsComm_t> qobj{comm_, query_str};
+            for(const auto& row : qobj) {
+                if(_recursive && !collection_is_within(row[0], _collection_name)) {
+                    continue;
+                }
+
+                if(row[2] != current_data_id) {
+                    if(finish_object()) {
+                        complete = false;
+                        break;
+                    }
+
+                    current_data_id   = row[2];
+                    current_path      = (row[0] == "/" ? row[0] : row[0] + "/") + row[1];
+                    current_size      = 0;
+                    current_indexable = false;
+                }
+
+                try {
+                    current_size = std::max(current_size, boost::lexical_cast<rodsLong_t>(row[4]));
+                }
+                catch(const boost::bad_lexical_cast&) {}
+
+                current_indexable = current_indexable ||
+                                    resource_is_indexable(row[3], *indexing_resources);
+            } // for row
+
+            if(complete) {
+                finish_object();
+            }
+            schedule_batch();
+
+            return complete;
+        } // schedule_policy_events_for_collection_objects
+
+        void indexer::reconcile_collection(
+            const std::string& _collection_name,
+            const std::string& _user_name,
+            const std::string& _indexer,
+            const std::string& _index_name,
+            const std::string& _index_type) {
+            if(index_type::full_text != _index_type) {
+                THROW(
+                    SYS_NOT_SUPPORTED,
+                    boost::format("reconciliation is not supported for index [%s] type [%s]")
+                    % _index_name
+                    % _index_type);
+            }
+
+            using json = nlohmann::json;
+            const auto start_time = std::chrono::steady_clock::now();
+            const auto indexing_resources = get_indexing_resource_names();
+
+            // documents are read from the index a page at a time, both sides
+            // are ordered by data id so only one page is ever held
+            struct indexed_object {
+                rodsLong_t  data_id;
+                rodsLong_t  modify_time;
+                std::string object_path;
+            };
+
+            std::deque<indexed_object> page;
+            std::string last_indexed_id{"0"};
+            bool        index_exhausted{false};
+            const auto list_policy = policy::compose_policy_name(
+                                         policy::collection::list,
+                                         _indexer);
+            auto fill_page = [&]() {
+                if(!page.empty() || index_exhausted) {
+                    return;
+                }
+
+                std::string results;
+                std::list<boost::any> args;
+                args.push_back(boost::any(_collection_name));
+                args.push_back(boost::any(_index_name));
+                args.push_back(boost::any(last_indexed_id));
+                args.push_back(boost::any(config_->reconcile_page_size));
+                args.push_back(boost::any(&results));
+                invoke_policy(rei_, list_policy, args);
+
+                for(const auto& doc : json::parse(results)) {
+                    page.push_back(indexed_object{
+                        doc.at("data_id").get<rodsLong_t>(),
+                        doc.value("modify_time", rodsLong_t{0}),
+                        doc.at("object_path").get<std::string>()});
+                }
+
+                if(page.empty()) {
+                    index_exhausted = true;
+                }
+                else {
+                    last_indexed_id = std::to_string(page.back().data_id);
+                }
+            }; // fill_page
+
+            std::vector<std::string> index_batch;
+            std::vector<std::string> purge_batch;
+            std::size_t missing_count{}, stale_count{}, orphaned_count{}, current_count{};
+            auto flush = [&](std::vector<std::string>& _batch, const std::string& _operation_type, bool _force) {
+                if(_batch.empty() ||
+                   (!_force && _batch.size() < static_cast<std::size_t>(config_->collection_batch_size))) {
+                    return;
+                }
 
-            std::string query_str {
-                boost::str(
-                    boost::format("SELECT RESC_NAME WHERE DATA_NAME = '%s' AND COLL_NAME = '%s'") %
-                        data_name %
-                        coll_name) };
-            query<rsComm_t> qobj{comm_, query_str, 1};
-            if(qobj.size() == 0) {
-                THROW(
-                    CAT_NO_ROWS_FOUND,
-                    boost::format("no resource names found for object [%s]")
-                    % _object_path);
-            }
+                schedule_policy_event_for_objects(
+                    operation_and_index_types_to_batch_policy_name(_operation_type, _index_type),
+                    _batch,
+                    _user_name,
+                    EMPTY_RESOURCE_NAME,
+                    _indexer,
+                    _index_name,
+                    _index_type,
+                    priority_class::bulk,
+                    generate_delay_execution_parameters(
+                        priority_class::bulk,
+                        _index_name,
+                        _batch.size(),
+                        0));
+                _batch.clear();
+            }; // flush
+
+            // a purge is by path, when a newer object now lives at the path it
+            // is reindexed instead which also drops the older documents
+            auto orphan = [&](const indexed_object& _doc) {
+                ++orphaned_count;
+                if(get_data_size_for_object(_doc.object_path) >= 0) {
+                    index_batch.push_back(_doc.object_path);
+                    flush(index_batch, operation_type::index, false);
+                    return;
+                }
 
-            if(_resource_names.empty()) {
-                return qobj.front()[0];
-            }
+                purge_batch.push_back(_doc.object_path);
+                flush(purge_batch, operation_type::purge, false);
+            }; // orphan
+
+            // merge join a catalog object against the documents of the index
+            auto reconcile_object = [&](
+                rodsLong_t         _data_id,
+                rodsLong_t         _modify_time,
+                const std::string& _object_path,
+                bool               _indexable) {
+                fill_page();
+                while(!page.empty() && page.front().data_id < _data_id) {
+                    orphan(page.front());
+                    page.pop_front();
+                    fill_page();
+                }
 
-            for(const auto& resource_name_for_object : qobj) {
-                for( const auto& resource_name_for_indexing : _resource_names) {
-                    if(resource_name_for_object[0] == resource_name_for_indexing) {
-                        return resource_name_for_object[0];
+                if(!page.empty() && page.front().data_id == _data_id) {
+                    const auto doc = page.front();
+                    page.pop_front();
+                    if(doc.modify_time >= _modify_time && doc.object_path == _object_path) {
+                        ++current_count;
+                        return;
                     }
+
+                    ++stale_count;
+                }
+                else if(_indexable) {
+                    ++missing_count;
+                }
+                else {
+                    return;
                 }
-            }
 
-            THROW(
-                SYS_INVALID_INPUT_PARAM,
-                boost::format("failed to find indexing resource for object [%s]")
-                % _object_path);
+                index_batch.push_back(_object_path);
+                flush(index_batch, operation_type::index, false);
+            }; // reconcile_object
 
-        } // get_indexing_resource_name_for_object
+            std::string query_str {
+                "SELECT COLL_NAME, DATA_NAME, ORDER(DATA_ID), DATA_MODIFY_TIME, RESC_NAME WHERE " +
+                collection_tree_condition(_collection_name)};
 
-        bool indexer::resource_is_indexable(
-                const std::string        _source_resource,
-                std::vector<std::string> _resource_names) {
-            if(_source_resource == EMPTY_RESOURCE_NAME ||
-               _resource_names.empty()) {
-                return true;
-            }
+            rodsLong_t  current_data_id{-1};
+            rodsLong_t  current_modify_time{};
+            std::string current_path;
+            bool        current_indexable{false};
+            query<rsComm_t> qobj{comm_, query_str};
+            for(const auto& row : qobj) {
+                if(!collection_is_within(row[0], _collection_name)) {
+                    continue;
+                }
 
-            for( const auto& resource_name_for_indexing : _resource_names) {
-                if(_source_resource == resource_name_for_indexing) {
-                    return true;
+                rodsLong_t data_id{}, modify_time{};
+                try {
+                    data_id     = boost::lexical_cast<rodsLong_t>(row[2]);
+                    modify_time = boost::lexical_cast<rodsLong_t>(row[3]);
+                }
+                catch(const boost::bad_lexical_cast&) {
+                    continue;
                 }
-            }
 
-            return false;
-        } // resource_is_indexable
+                if(data_id != current_data_id) {
+                    if(current_data_id >= 0) {
+                        reconcile_object(current_data_id, current_modify_time, current_path, current_indexable);
+                    }
 
-        std::tuple<std::string, std::string>
-        indexer::parse_indexer_string(
-            const std::string& _indexer_string) {
+                    current_data_id     = data_id;
+                    current_modify_time = 0;
+                    current_path        = (row[0] == "/" ? row[0] : row[0] + "/") + row[1];
+                    current_indexable   = false;
+                }
 
-            const auto pos = _indexer_string.find_last_of(indexer_separator);
-            if(std::string::npos == pos) {
-                THROW(
-                   SYS_INVALID_INPUT_PARAM,
-                   boost::format("[%s] does not include an index separator for collection")
-                   % _indexer_string);
-            }
-            const auto index_name = _indexer_string.substr(0, pos-(indexer_separator.size()-1));
-            const auto index_type = _indexer_string.substr(pos+1);
-            return std::make_tuple(index_name, index_type);
-        }
+                current_modify_time = std::max(current_modify_time, modify_time);
+                current_indexable   = current_indexable ||
+                                      resource_is_indexable(row[4], *indexing_resources);
+            } // for row
 
-        void indexer::schedule_policy_events_for_collection(
-            const std::string& _operation_type,
-            const std::string& _collection_name,
-            const std::string& _user_name,
-            const std::string& _indexer,
-            const std::string& _index_name,
-            const std::string& _index_type) {
-            namespace fs   = irods::experimental::filesystem;
-            namespace fsvr = irods::experimental::filesystem::server;
-            using     fsp  = fs::path;
-            rsComm_t& comm = *rei_->rsComm;
+            if(current_data_id >= 0) {
+                reconcile_object(current_data_id, current_modify_time, current_path, current_indexable);
+            }
 
-            const auto indexing_resources = get_indexing_resource_names();
-            const auto policy_name = operation_and_index_types_to_policy_name(
-                                         _operation_type,
-                                         _index_type);
-            fsp start_path{_collection_name};
+            // whatever remains in the index is no longer in the catalog
+            fill_page();
+            while(!page.empty()) {
+                orphan(page.front());
+                page.pop_front();
+                fill_page();
+            }
 
-            if (fsvr::collection_iterator{} == fsvr::collection_iterator{comm, start_path}) { return; }
+            flush(index_batch, operation_type::index, true);
+            flush(purge_batch, operation_type::purge, true);
 
-            for(auto p : fsvr::recursive_collection_iterator(comm, start_path)) {
-                if(fsvr::is_data_object(comm, p.path())) {
-                    try {
-                        std::string resc_name = get_indexing_resource_name_for_object(
-                                                   p.path().string(),
-                                                   indexing_resources); 
-                        schedule_policy_event_for_object(
-                            policy_name,
-                            p.path().string(),
-                            _user_name,
-                            EMPTY_RESOURCE_NAME,
-                            _indexer,
-                            _index_name,
-                            _index_type,
-                            generate_delay_execution_parameters());
-                    }
-                    catch(const exception& _e) {
-                        rodsLog(
-                            LOG_ERROR,
-                            "failed to find indexing resource for object [%s]",
-                            p.path().string().c_str());
-                    }
-                } // if data object
-            } // for path
-        } // schedule_policy_events_for_collection
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+            rodsLog(
+                LOG_NOTICE,
+                "irods::indexing::indexer reconciled collection [%s] index [%s] in [%f] seconds - current [%d] missing [%d] stale [%d] orphaned [%d]",
+                _collection_name.c_str(),
+                _index_name.c_str(),
+                elapsed.count(),
+                static_cast<int>(current_count),
+                static_cast<int>(missing_count),
+                static_cast<int>(stale_count),
+                static_cast<int>(orphaned_count));
+        } // reconcile_collection
 
         void indexer::schedule_full_text_indexing_event(
             const std::string& _object_path,
             const std::string& _user_name,
-            const std::string& _source_resource) {
+            const std::string& _source_resource,
+            rodsLong_t         _data_size) {
             schedule_policy_events_given_object_path(
                 irods::indexing::operation_type::index,
                 irods::indexing::index_type::full_text,
                 _object_path,
                 _user_name,
-                _source_resource);
+                _source_resource,
+                {},
+                {},
+                {},
+                _data_size);
         } // schedule_full_text_indexing_event
 
         void indexer::schedule_full_text_purge_event(
@@ -292,7 +1533,8 @@ namespace irods {
                 irods::indexing::operation_type::purge,
                 irods::indexing::index_type::full_text,
                 _object_path,
-                _user_name);
+                _user_name,
+                EMPTY_RESOURCE_NAME);
         } // schedule_full_text_purge_event
 
         void indexer::schedule_metadata_indexing_event(
@@ -341,11 +1583,10 @@ namespace irods {
             const std::string& _source_resource,
             const std::string& _attribute,
             const std::string& _value,
-            const std::string& _units) {
-            using fsp = irods::experimental::filesystem::path;
-
+            const std::string& _units,
+            rodsLong_t         _data_size) {
             const auto indexing_resources = get_indexing_resource_names();
-            if(!resource_is_indexable(_source_resource, indexing_resources)) {
+            if(!resource_is_indexable(_source_resource, *indexing_resources)) {
                 rodsLog(
                     LOG_ERROR,
                     "resource [%s] is not indexable for object [%s]",
@@ -354,86 +1595,429 @@ namespace irods {
                 return;
             }
 
-            std::vector<std::string> processed_indicies;
+            const auto targets = get_index_targets_for_object(_object_path, _index_type);
+            if(targets.empty()) {
+                return;
+            }
+
+            // only a full text index reads the object
+            rodsLong_t byte_count{0};
+            if(operation_type::index == _operation_type &&
+               index_type::full_text == _index_type) {
+                byte_count = _data_size >= 0 ?
+                             _data_size :
+                             std::max<rodsLong_t>(0, get_data_size_for_object(_object_path));
+            }
+
+            const auto priority = get_priority_class(
+                                      _operation_type,
+                                      _index_type,
+                                      byte_count,
+                                      {_object_path});
+
+            // full text indices of the same technology share a single read
+            // of the object
+            std::map<std::string, std::vector<std::string>> shared_reads;
+            if(operation_type::index == _operation_type &&
+               index_type::full_text == _index_type) {
+                for(const auto& target : targets) {
+                    shared_reads[target.indexer].push_back(target.index_name);
+                }
+            }
+
+            for(const auto& shared_read : shared_reads) {
+                if(shared_read.second.size() < 2) {
+                    continue;
+                }
+
+                schedule_multiple_index_event_for_object(
+                    _object_path,
+                    _user_name,
+                    _source_resource,
+                    shared_read.first,
+                    shared_read.second,
+                    priority,
+                    generate_delay_execution_parameters(
+                        priority,
+                        shared_read.second,
+                        1,
+                        byte_count));
+            } // for shared_read
+
+            for(const auto& target : targets) {
+                const auto shared_read = shared_reads.find(target.indexer);
+                if(shared_read != shared_reads.end() && shared_read->second.size() > 1) {
+                    continue;
+                }
+
+                const auto policy_name = operation_and_index_types_to_policy_name(
+                                             _operation_type,
+                                             _index_type);
+                schedule_policy_event_for_object(
+                    policy_name,
+                    _object_path,
+                    _user_name,
+                    _source_resource,
+                    target.indexer,
+                    target.index_name,
+                    target.index_type,
+                    priority,
+                    generate_delay_execution_parameters(
+                        priority,
+                        target.index_name,
+                        1,
+                        byte_count),
+                    _attribute,
+                    _value,
+                    _units);
+            } // for target
+
+        } // schedule_policy_events_given_object_path
+
+        std::vector<index_target> indexer::get_index_targets_for_object(
+            const std::string& _object_path,
+            const std::string& _index_type) {
+            using fsp = irods::experimental::filesystem::path;
+
+            std::vector<index_target> ret_val;
             fsp full_path{_object_path};
-            auto coll = full_path.parent_path();
-            while(!coll.empty()) {
+            const auto metadata = get_index_metadata_for_path(
+                                      full_path.parent_path().string());
+            for(const auto& row : metadata) {
+                const auto& indexer_string = row.first;
+                const auto& indexer = row.second;
+                std::string index_name, index_type;
                 try {
-                    auto metadata = 
-                        get_metadata_for_collection(
-                            coll.string(),
-                            config_.index);
-                    for(const auto& row : metadata) {
-                        const auto& indexer_string = row.first;
-                        const auto& indexer = row.second;
-                        std::string index_name, index_type;
-                        std::tie(index_name, index_type) = parse_indexer_string(indexer_string);
-                        if(_index_type == index_type) {
-                            auto itr = std::find(
-                                           std::begin(processed_indicies),
-                                           std::end(processed_indicies),
-                                           index_name+index_type);
-                            if(itr != std::end(processed_indicies)) {
-                                continue;
-                            }
-                            const auto policy_name = operation_and_index_types_to_policy_name(
-                                                         _operation_type,
-                                                         _index_type);
-                            schedule_policy_event_for_object(
-                                policy_name,
-                                _object_path,
-                                _user_name,
-                                _source_resource,
-                                indexer,
-                                index_name,
-                                index_type,
-                                generate_delay_execution_parameters(),
-                                _attribute,
-                                _value,
-                                _units);
-                            processed_indicies.push_back(index_name+index_type);
-                        }
-                    } // for row
+                    std::tie(index_name, index_type) = parse_indexer_string(indexer_string);
                 }
                 catch(const irods::exception&) {
+                    continue;
                 }
 
-                if (0 == coll.compare(coll.root_collection())) { break; }
-                coll = coll.parent_path();
+                if(_index_type != index_type) {
+                    continue;
+                }
+
+                auto itr = std::find_if(
+                               std::begin(ret_val),
+                               std::end(ret_val),
+                               [&](const index_target& _t) {
+                                   return _t.index_name == index_name &&
+                                          _t.index_type == index_type;
+                               });
+                if(itr != std::end(ret_val)) {
+                    continue;
+                }
 
-            } // while
+                ret_val.push_back(index_target{indexer, index_name, index_type});
+            } // for row
 
-        } // schedule_policy_events_given_object_path
+            return ret_val;
+        } // get_index_targets_for_object
+
+        void indexer::schedule_indexing_events(
+            const std::vector<indexing_event>& _events) {
+            // whole object events are grouped by everything but the object path
+            using group_key = std::tuple<std::string, std::string, std::string, std::string, std::string, std::string>;
+            std::map<group_key, std::vector<std::string>> groups;
+            std::set<std::tuple<group_key, std::string>>  seen;
+            std::map<std::string, rodsLong_t>             data_sizes;
+
+            const auto indexing_resources = get_indexing_resource_names();
+            for(const auto& event : _events) {
+                // events for a single avu are scheduled as they are
+                if(!event.attribute.empty()) {
+                    schedule_policy_events_given_object_path(
+                        event.operation_type,
+                        event.index_type,
+                        event.object_path,
+                        event.user_name,
+                        event.source_resource,
+                        event.attribute,
+                        event.value,
+                        event.units,
+                        event.data_size);
+                    continue;
+                }
+
+                if(!resource_is_indexable(event.source_resource, *indexing_resources)) {
+                    rodsLog(
+                        LOG_ERROR,
+                        "resource [%s] is not indexable for object [%s]",
+                        event.source_resource.c_str(),
+                        event.object_path.c_str());
+                    continue;
+                }
+
+                if(event.data_size >= 0) {
+                    data_sizes[event.object_path] = event.data_size;
+                }
+
+                for(const auto& target : get_index_targets_for_object(event.object_path, event.index_type)) {
+                    const group_key key{
+                        event.operation_type,
+                        event.user_name,
+                        event.source_resource,
+                        target.indexer,
+                        target.index_name,
+                        target.index_type};
+                    if(seen.insert(std::make_tuple(key, event.object_path)).second) {
+                        groups[key].push_back(event.object_path);
+                    }
+                } // for target
+            } // for event
+
+            for(const auto& group : groups) {
+                std::string operation_type, user_name, source_resource, indexer, index_name, index_type;
+                std::tie(operation_type, user_name, source_resource, indexer, index_name, index_type) = group.first;
+                const auto& object_paths = group.second;
+
+                if(object_paths.size() == 1) {
+                    const auto& object_path = object_paths.front();
+                    const bool  reads_data  = irods::indexing::operation_type::index == operation_type &&
+                                              irods::indexing::index_type::full_text == index_type;
+                    const auto  size_itr    = data_sizes.find(object_path);
+                    rodsLong_t  byte_count{0};
+                    if(reads_data) {
+                        byte_count = size_itr == data_sizes.end() ?
+                                     std::max<rodsLong_t>(0, get_data_size_for_object(object_path)) :
+                                     size_itr->second;
+                    }
+
+                    const auto  priority    = get_priority_class(
+                                                  operation_type,
+                                                  index_type,
+                                                  byte_count,
+                                                  {object_path});
+                    schedule_policy_event_for_object(
+                        operation_and_index_types_to_policy_name(operation_type, index_type),
+                        object_paths.front(),
+                        user_name,
+                        source_resource,
+                        indexer,
+                        index_name,
+                        index_type,
+                        priority,
+                        generate_delay_execution_parameters(
+                            priority,
+                            index_name,
+                            1,
+                            byte_count));
+                    continue;
+                }
+
+                // a batch runs in the lane of its largest member, sizes which
+                // were not captured at the pep are treated as small
+                const auto batch_size = static_cast<std::size_t>(config_->collection_batch_size);
+                for(std::size_t i = 0; i < object_paths.size(); i += batch_size) {
+                    const auto end = std::min(object_paths.size(), i + batch_size);
+                    rodsLong_t largest{0};
+                    rodsLong_t total{0};
+                    for(auto j = i; j < end; ++j) {
+                        const auto size_itr = data_sizes.find(object_paths[j]);
+                        if(size_itr != data_sizes.end()) {
+                            largest = std::max(largest, size_itr->second);
+                            total  += size_itr->second;
+                        }
+                    }
+
+                    const std::vector<std::string> batch(object_paths.begin() + i, object_paths.begin() + end);
+                    const auto priority = get_priority_class(
+                                              operation_type,
+                                              index_type,
+                                              largest,
+                                              batch);
+                    schedule_policy_event_for_objects(
+                        operation_and_index_types_to_batch_policy_name(operation_type, index_type),
+                        batch,
+                        user_name,
+                        source_resource,
+                        indexer,
+                        index_name,
+                        index_type,
+                        priority,
+                        generate_delay_execution_parameters(
+                            priority,
+                            index_name,
+                            end - i,
+                            irods::indexing::operation_type::index == operation_type &&
+                            irods::indexing::index_type::full_text == index_type ? total : 0));
+                }
+            } // for group
+        } // schedule_indexing_events
+
+        std::string indexer::get_priority_class(
+            const std::string&              _operation_type,
+            const std::string&              _index_type,
+            rodsLong_t                      _data_size,
+            const std::vector<std::string>& _object_paths) {
+            if(index_type::metadata == _index_type) {
+                return priority_class::metadata;
+            }
+
+            // a purge never reads the object
+            if(operation_type::purge == _operation_type) {
+                return priority_class::small_full_text;
+            }
+
+            if(config_->defer_archive_only_objects &&
+               !_object_paths.empty() &&
+               std::all_of(
+                   _object_paths.begin(),
+                   _object_paths.end(),
+                   [this](const std::string& _p) { return object_is_archive_only(_p); })) {
+                return priority_class::bulk;
+            }
+
+            return _data_size >= config_->large_object_size_in_bytes ?
+                   priority_class::large_full_text :
+                   priority_class::small_full_text;
+        } // get_priority_class
+
+        rodsLong_t indexer::get_data_size_for_object(
+            const std::string& _object_path) {
+            using fsp = irods::experimental::filesystem::path;
+
+            fsp path{_object_path};
+            std::string query_str {
+                boost::str(
+                        boost::format("SELECT DATA_SIZE WHERE COLL_NAME = '%s' AND DATA_NAME = '%s'")
+                        % path.parent_path().string()
+                        % path.object_name().string())};
+
+            rodsLong_t ret_val{-1};
+            query<rsComm_t> qobj{comm_, query_str};
+            for(const auto& row : qobj) {
+                try {
+                    ret_val = std::max(ret_val, boost::lexical_cast<rodsLong_t>(row[0]));
+                }
+                catch(const boost::bad_lexical_cast&) {}
+            }
+
+            return ret_val;
+        } // get_data_size_for_object
+
+        int indexer::reserve_index_capacity(
+            const std::string& _index_name,
+            std::size_t        _document_count,
+            rodsLong_t         _byte_count) {
+            auto limit_itr = config_->index_rate_limits.find(_index_name);
+            if(limit_itr == config_->index_rate_limits.end()) {
+                limit_itr = config_->index_rate_limits.find(default_rate_limit);
+            }
+
+            if(limit_itr == config_->index_rate_limits.end() ||
+               (limit_itr->second.documents_per_second <= 0 &&
+                limit_itr->second.bytes_per_second <= 0)) {
+                return -1;
+            }
+
+            const auto& limit = limit_itr->second;
+            double cost{};
+            if(limit.documents_per_second > 0) {
+                cost += static_cast<double>(_document_count) / limit.documents_per_second;
+            }
+            if(limit.bytes_per_second > 0) {
+                cost += static_cast<double>(_byte_count) / limit.bytes_per_second;
+            }
+
+            const double wall_now = static_cast<double>(std::time(nullptr));
+
+            double start{}, drain{};
+            {
+                std::lock_guard<std::mutex> lock{rate_buckets.mutex};
+                auto& next_start = rate_buckets.next_start[_index_name];
+                next_start = std::max(next_start, wall_now);
+                start      = next_start;
+                next_start += cost;
+                drain      = next_start - wall_now;
+            }
+
+            const auto delay = static_cast<int>(std::ceil(start - wall_now));
+            rodsLog(
+                config_->log_level,
+                "irods::indexing index [%s] job of [%d] objects and [%lld] bytes starts in [%d] seconds, scheduled work drains in [%f] seconds",
+                _index_name.c_str(),
+                static_cast<int>(_document_count),
+                static_cast<long long>(_byte_count),
+                delay,
+                drain);
+
+            return delay;
+        } // reserve_index_capacity
+
+        std::string indexer::generate_delay_execution_parameters(
+            const std::string& _priority_class,
+            const std::string& _index_name,
+            std::size_t        _document_count,
+            rodsLong_t         _byte_count) {
+            return generate_delay_execution_parameters(
+                       _priority_class,
+                       std::vector<std::string>{_index_name},
+                       _document_count,
+                       _byte_count);
+        } // generate_delay_execution_parameters
 
-        std::string indexer::generate_delay_execution_parameters() {
-            std::string params{config_.delay_parameters + "<INST_NAME>" + config_.instance_name_ + "</INST_NAME>"};
+        std::string indexer::generate_delay_execution_parameters(
+            const std::string&              _priority_class,
+            const std::vector<std::string>& _index_names,
+            std::size_t                     _document_count,
+            rodsLong_t                      _byte_count) {
+            std::string params{config_->delay_parameters + "<INST_NAME>" + config_->instance_name_ + "</INST_NAME>"};
+
+            int reserved_delay{-1};
+            for(const auto& index_name : _index_names) {
+                reserved_delay = std::max(
+                                     reserved_delay,
+                                     reserve_index_capacity(
+                                         index_name,
+                                         _document_count,
+                                         _byte_count));
+            }
 
             int min_time{1};
             try {
-                min_time = boost::lexical_cast<int>(config_.minimum_delay_time);
+                min_time = boost::lexical_cast<int>(config_->minimum_delay_time);
             }
             catch(const boost::bad_lexical_cast&) {}
 
             int max_time{30};
             try {
-                max_time = boost::lexical_cast<int>(config_.maximum_delay_time);
+                max_time = boost::lexical_cast<int>(config_->maximum_delay_time);
             }
             catch(const boost::bad_lexical_cast&) {}
 
             std::string sleep_time{"1"};
-            try {
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<> dis(min_time, max_time);
-                sleep_time = boost::lexical_cast<std::string>(dis(gen));
+            if(reserved_delay >= 0) {
+                sleep_time = std::to_string(reserved_delay);
+            }
+            else {
+                try {
+                    std::random_device rd;
+                    std::mt19937 gen(rd());
+                    std::uniform_int_distribution<> dis(min_time, max_time);
+                    sleep_time = boost::lexical_cast<std::string>(dis(gen));
+                }
+                catch(const boost::bad_lexical_cast&) {}
             }
-            catch(const boost::bad_lexical_cast&) {}
 
             params += "<PLUSET>"+sleep_time+"s</PLUSET>";
 
+            int priority{config_->small_full_text_priority};
+            if(priority_class::metadata == _priority_class) {
+                priority = config_->metadata_priority;
+            }
+            else if(priority_class::large_full_text == _priority_class) {
+                priority = config_->large_full_text_priority;
+            }
+            else if(priority_class::bulk == _priority_class) {
+                priority = config_->bulk_priority;
+            }
+            params += "<PRIORITY>"+std::to_string(priority)+"</PRIORITY>";
+
             rodsLog(
-                config_.log_level,
-                "irods::storage_tiering :: delay params min [%d] max [%d] computed [%s]",
+                config_->log_level,
+                "irods::indexing :: delay params min [%d] max [%d] computed [%s]",
                 min_time,
                 max_time,
                 params.c_str());
@@ -442,6 +2026,53 @@ namespace irods {
 
         } // generate_delay_execution_parameters
 
+        std::string indexer::get_object_generation(
+            const std::string& _object_path) {
+            using fsp = irods::experimental::filesystem::path;
+
+            // a write advances the modify time of the replica written and
+            // marks the others stale, a replication adds a newer good replica
+            // but leaves the oldest as it was
+            fsp path{_object_path};
+            std::string query_str {
+                boost::str(
+                        boost::format("SELECT DATA_MODIFY_TIME WHERE COLL_NAME = '%s' AND DATA_NAME = '%s' AND DATA_REPL_STATUS = '1'")
+                        % path.parent_path().string()
+                        % path.object_name().string())};
+
+            // modify times are zero padded, they order as strings
+            std::string ret_val;
+            query<rsComm_t> qobj{comm_, query_str};
+            for(const auto& row : qobj) {
+                if(ret_val.empty() || row[0] < ret_val) {
+                    ret_val = row[0];
+                }
+            }
+
+            return ret_val;
+        } // get_object_generation
+
+        bool indexer::object_generation_is_stale(
+            const std::string& _object_path,
+            const std::string& _generation) {
+            if(_generation.empty()) {
+                return false;
+            }
+
+            const auto current = get_object_generation(_object_path);
+            if(current.empty()) {
+                return false;
+            }
+
+            try {
+                return boost::lexical_cast<long long>(current) >
+                       boost::lexical_cast<long long>(_generation);
+            }
+            catch(const boost::bad_lexical_cast&) {
+                return false;
+            }
+        } // object_generation_is_stale
+
         void indexer::get_metadata_for_data_object(
             const std::string& _meta_attr_name,
             const std::string& _object_path,
@@ -470,30 +2101,46 @@ namespace irods {
             _unit  = qobj.front()[1];
         } // get_metadata_for_data_object
 
-        indexer::metadata_results indexer::get_metadata_for_collection(
-            const std::string& _collection,
-            const std::string& _meta_attr_name) {
-            std::string query_str {
-                boost::str(
-                        boost::format("SELECT META_COLL_ATTR_VALUE, META_COLL_ATTR_UNITS WHERE META_COLL_ATTR_NAME = '%s' and COLL_NAME = '%s'") %
-                        _meta_attr_name %
-                        _collection) };
-            query<rsComm_t> qobj{comm_, query_str, 1};
-            if(qobj.size() == 0) {
-                THROW(
-                    CAT_NO_ROWS_FOUND,
-                    boost::format("no results found for collection [%s] with attribute [%s]") %
-                    _collection %
-                    _meta_attr_name);
+        indexer::metadata_results indexer::get_index_metadata_for_path(
+            const std::string& _path) {
+            return query_indexed_collections(
+                       [&_path](const collection_trie& _trie) {
+                           return _trie.metadata_for_path(_path);
+                       });
+        } // get_index_metadata_for_path
+
+        indexer::metadata_results indexer::query_indexed_collections(
+            const std::function<metadata_results(const collection_trie&)>& _fcn) {
+            const auto now = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lock{collection_cache.mutex};
+                if(collection_cache.trie && now < collection_cache.expiration) {
+                    return _fcn(*collection_cache.trie);
+                }
             }
 
-            metadata_results ret_val;
+            // load every indexed collection in the zone with a single query
+            std::string query_str {
+                boost::str(
+                        boost::format("SELECT COLL_NAME, META_COLL_ATTR_VALUE, META_COLL_ATTR_UNITS WHERE META_COLL_ATTR_NAME = '%s'") %
+                        config_->index) };
+            query<rsComm_t> qobj{comm_, query_str};
+            auto trie = std::make_unique<collection_trie>();
             for(const auto& row : qobj) {
-                ret_val.push_back(std::make_pair(row[0], row[1]));
+                trie->insert(row[0], row[1], row[2]);
             }
 
-            return ret_val;
-        } // get_metadata_for_collection
+            rodsLog(
+                config_->log_level,
+                "irods::indexing::indexer loaded [%d] indexed collection annotations",
+                static_cast<int>(trie->size()));
+
+            std::lock_guard<std::mutex> lock{collection_cache.mutex};
+            collection_cache.trie       = std::move(trie);
+            collection_cache.expiration = now + std::chrono::seconds(config_->collection_cache_ttl_in_seconds);
+
+            return _fcn(*collection_cache.trie);
+        } // query_indexed_collections
 
         void indexer::schedule_policy_event_for_object(
             const std::string& _event,
@@ -503,6 +2150,7 @@ namespace irods {
             const std::string& _indexer,
             const std::string& _index_name,
             const std::string& _index_type,
+            const std::string& _priority_class,
             const std::string& _data_movement_params,
             const std::string& _attribute,
             const std::string& _value,
@@ -510,7 +2158,7 @@ namespace irods {
             using json = nlohmann::json;
             json rule_obj;
             rule_obj["rule-engine-operation"]     = _event;
-            rule_obj["rule-engine-instance-name"] = config_.instance_name_;
+            rule_obj["rule-engine-instance-name"] = config_->instance_name_;
             rule_obj["object-path"]               = _object_path;
             rule_obj["user-name"]                 = _user_name;
             rule_obj["indexer"]                   = _indexer;
@@ -520,15 +2168,19 @@ namespace irods {
             rule_obj["attribute"]                 = _attribute;
             rule_obj["value"]                     = _value;
             rule_obj["units"]                     = _units;
+            rule_obj["priority-class"]            = _priority_class;
+            if(policy::object::index == _event && index_type::full_text == _index_type) {
+                rule_obj["object-generation"] = get_object_generation(_object_path);
+            }
 
-            const auto delay_err = _delayExec(
-                                       rule_obj.dump().c_str(),
-                                       "",
-                                       _data_movement_params.c_str(),
-                                       rei_);
-            if(delay_err < 0) {
+            try {
+                schedule_indexing_policy(
+                    rule_obj.dump(),
+                    _data_movement_params);
+            }
+            catch(const irods::exception& _e) {
                 THROW(
-                    delay_err,
+                    _e.code(),
                     boost::format("queue indexing event failed for object [%s] indexer [%s] type [%s]") %
                     _object_path %
                     _indexer %
@@ -536,13 +2188,157 @@ namespace irods {
             }
 
             rodsLog(
-                config_.log_level,
+                config_->log_level,
                 "irods::indexing::indexer indexing object [%s] with [%s] type [%s]",
                 _object_path.c_str(),
                 _indexer.c_str(),
                 _index_type.c_str());
 
         } // schedule_policy_event_for_object
+
+        void indexer::schedule_multiple_index_event_for_object(
+            const std::string&              _object_path,
+            const std::string&              _user_name,
+            const std::string&              _source_resource,
+            const std::string&              _indexer,
+            const std::vector<std::string>& _index_names,
+            const std::string&              _priority_class,
+            const std::string&              _data_movement_params) {
+            using json = nlohmann::json;
+            json rule_obj;
+            rule_obj["rule-engine-operation"]     = policy::object::index_multiple;
+            rule_obj["rule-engine-instance-name"] = config_->instance_name_;
+            rule_obj["object-path"]               = _object_path;
+            rule_obj["user-name"]                 = _user_name;
+            rule_obj["indexer"]                   = _indexer;
+            rule_obj["index-names"]               = _index_names;
+            rule_obj["index-type"]                = index_type::full_text;
+            rule_obj["source-resource"]           = _source_resource;
+            rule_obj["priority-class"]            = _priority_class;
+            rule_obj["object-generation"]         = get_object_generation(_object_path);
+
+            try {
+                schedule_indexing_policy(
+                    rule_obj.dump(),
+                    _data_movement_params);
+            }
+            catch(const irods::exception& _e) {
+                THROW(
+                    _e.code(),
+                    boost::format("queue indexing event failed for object [%s] indexer [%s] indices [%s]") %
+                    _object_path %
+                    _indexer %
+                    boost::algorithm::join(_index_names, ","));
+            }
+
+            rodsLog(
+                config_->log_level,
+                "irods::indexing::indexer indexing object [%s] with [%s] into [%s]",
+                _object_path.c_str(),
+                _indexer.c_str(),
+                boost::algorithm::join(_index_names, ",").c_str());
+        } // schedule_multiple_index_event_for_object
+
+        void indexer::schedule_policy_event_for_objects(
+            const std::string&              _event,
+            const std::vector<std::string>& _object_paths,
+            const std::string&              _user_name,
+            const std::string&              _source_resource,
+            const std::string&              _indexer,
+            const std::string&              _index_name,
+            const std::string&              _index_type,
+            const std::string&              _priority_class,
+            const std::string&              _data_movement_params,
+            const std::string&              _execution_host) {
+            // a batch is split by the host of each object so that every job
+            // reads from local storage
+            if(config_->execute_near_data &&
+               policy::object::index_batch == _event &&
+               _execution_host.empty()) {
+                std::map<std::string, std::vector<std::string>> hosts;
+                for(const auto& object_path : _object_paths) {
+                    hosts[get_execution_host_for_object(object_path)].push_back(object_path);
+                }
+
+                if(hosts.size() > 1 ||
+                   (1 == hosts.size() && !hosts.begin()->first.empty())) {
+                    for(const auto& h : hosts) {
+                        schedule_policy_event_for_objects(
+                            _event,
+                            h.second,
+                            _user_name,
+                            _source_resource,
+                            _indexer,
+                            _index_name,
+                            _index_type,
+                            _priority_class,
+                            _data_movement_params,
+                            h.first);
+                    }
+                    return;
+                }
+            }
+
+            using json = nlohmann::json;
+            json rule_obj;
+            rule_obj["rule-engine-operation"]     = _event;
+            rule_obj["rule-engine-instance-name"] = config_->instance_name_;
+            rule_obj["object-paths"]              = _object_paths;
+            rule_obj["user-name"]                 = _user_name;
+            rule_obj["indexer"]                   = _indexer;
+            rule_obj["index-name"]                = _index_name;
+            rule_obj["index-type"]                = _index_type;
+            rule_obj["source-resource"]           = _source_resource;
+            rule_obj["priority-class"]            = _priority_class;
+            if(!_execution_host.empty()) {
+                rule_obj["execution-host"] = _execution_host;
+            }
+
+            // rule text is held in a META_STR_LEN buffer by both the delay
+            // server and exec my rule, split batches which would not fit
+            const auto rule_text = rule_obj.dump();
+            if(rule_text.size() + sizeof("@external\n") > META_STR_LEN &&
+               _object_paths.size() > 1) {
+                const auto middle = _object_paths.begin() + _object_paths.size() / 2;
+                for(const auto& paths : {std::vector<std::string>(_object_paths.begin(), middle),
+                                         std::vector<std::string>(middle, _object_paths.end())}) {
+                    schedule_policy_event_for_objects(
+                        _event,
+                        paths,
+                        _user_name,
+                        _source_resource,
+                        _indexer,
+                        _index_name,
+                        _index_type,
+                        _priority_class,
+                        _data_movement_params,
+                        _execution_host);
+                }
+                return;
+            }
+
+            try {
+                schedule_indexing_policy(
+                    rule_text,
+                    _data_movement_params);
+            }
+            catch(const irods::exception& _e) {
+                THROW(
+                    _e.code(),
+                    boost::format("queue indexing batch of [%d] objects failed indexer [%s] type [%s]") %
+                    _object_paths.size() %
+                    _indexer %
+                    _index_type);
+            }
+
+            rodsLog(
+                config_->log_level,
+                "irods::indexing::indexer indexing batch of [%d] objects with [%s] type [%s]",
+                static_cast<int>(_object_paths.size()),
+                _indexer.c_str(),
+                _index_type.c_str());
+
+        } // schedule_policy_event_for_objects
     } // namespace indexing
 }; // namespace irods
 
@@ -3,18 +3,98 @@
 #ifndef INDEXING_UTILITIES_HPP
 #define INDEXING_UTILITIES_HPP
 
+#include <array>
+#include <functional>
 #include <list>
+#include <map>
+#include <memory>
 #include <boost/any.hpp>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 #include "rcMisc.h"
 #include "configuration.hpp"
+#include "collection_trie.hpp"
+#include "worker_pool.hpp"
 
 namespace irods {
     namespace indexing {
+        using resource_name_set = std::unordered_set<std::string>;
+
+        // what the read cost model needs of a resource
+        struct resource_properties {
+            std::string type;
+            std::string location;
+            int         read_cost{};
+            bool        has_read_cost{};
+        }; // struct resource_properties
+
+        using resource_property_map = std::map<std::string, resource_properties>;
+
+        // drop the process level cache of indexing resource names and
+        // resource properties, to be called when resource metadata changes
+        void invalidate_indexing_resource_cache();
+
+        // drop the process level trie of indexed collections
+        void invalidate_indexed_collection_cache();
+
+        // apply a collection metadata operation on the indexing attribute to
+        // the process level trie of indexed collections, if it is loaded
+        void update_indexed_collection_cache(
+            const std::string& _operation,
+            const std::string& _collection_name,
+            const std::string& _value,
+            const std::string& _units);
+
+        // schedule every further job of this process on the delay server,
+        // for agents which themselves execute jobs
+        void disable_worker_pool();
+
+        // stop the process level worker pool, if one was started, returning
+        // the jobs it did not execute
+        std::vector<pending_job> stop_worker_pool();
+
+        // an object event as raised by a policy enforcement point
+        struct indexing_event {
+            std::string operation_type;
+            std::string index_type;
+            std::string object_path;
+            std::string user_name;
+            std::string source_resource;
+            std::string attribute;
+            std::string value;
+            std::string units;
+            rodsLong_t  data_size{-1};
+        }; // struct indexing_event
+
+        // an attribute, value and units triple
+        using avu = std::array<std::string, 3>;
+
+        // an index into which an object event is delivered
+        struct index_target {
+            std::string indexer;
+            std::string index_name;
+            std::string index_type;
+        }; // struct index_target
+
+        // the cost of reading one good replica of an object
+        struct replica_read_cost {
+            int         replica_number{-1};
+            int         resource_cost{};
+            bool        remote{};
+            std::string host;
+            rodsLong_t  data_size{};
+        }; // struct replica_read_cost
+
+        // whether a resource location names this server
+        bool host_is_local(const std::string& _host);
+
         class indexer {
 
             public:
+            static constexpr const char* EMPTY_RESOURCE_NAME{"EMPTY_RESOURCE_NAME"};
+
             indexer(
                 ruleExecInfo_t*    _rei,
                 const std::string& _instance_name);
@@ -23,6 +103,15 @@ namespace irods {
                 const std::string& _json,
                 const std::string& _params);
 
+            void schedule_delayed_indexing_policy(
+                const std::string& _json,
+                const std::string& _params);
+
+            // whether a job targets an index with a rate limit, whose jobs
+            // are left to the delay server to start when reserved
+            bool job_is_rate_limited(
+                const std::string& _json);
+
             bool metadata_exists_on_collection(
                 const std::string& _collection_name,
                 const std::string& _attribute,
@@ -36,18 +125,97 @@ namespace irods {
                 const std::string& _indexer_string,
                 const std::string& _indexer);
 
+            // schedule a single crawl of a collection for each full text
+            // index which applies to it, as when a directory tree has been
+            // registered into the collection
+            void schedule_registered_collection(
+                const std::string& _collection_name,
+                const std::string& _user_name);
+
             void schedule_policy_events_for_collection(
-                const std::string& _policy_name,
+                const std::string&              _operation_type,
+                const std::vector<std::string>& _collection_names,
+                const std::string&              _user_name,
+                const std::string&              _indexer,
+                const std::string&              _index_name,
+                const std::string&              _index_type,
+                const std::string&              _continuation_token = {});
+
+            // remove the documents of every object within the collections
+            // from an index, by a single technology operation per collection
+            // where the technology supports it and otherwise by crawling
+            void purge_collections(
+                const std::vector<std::string>& _collection_names,
+                const std::string&              _user_name,
+                const std::string&              _indexer,
+                const std::string&              _index_name,
+                const std::string&              _index_type,
+                const std::string&              _continuation_token = {});
+
+            // whether a good replica of the object other than the one on
+            // _resource_name resides on an indexable resource, in which case
+            // its content was indexed when that replica was written
+            bool object_has_indexed_replica(
+                const std::string& _object_path,
+                const std::string& _resource_name);
+
+            // the oldest modify time of the good replicas of an object, which
+            // advances with each write, recorded by a full text job as it is
+            // scheduled.  empty when the object has no good replica
+            std::string get_object_generation(
+                const std::string& _object_path);
+
+            // whether the object was written after a job recording the
+            // given generation was scheduled, the later write scheduling a
+            // job of its own
+            bool object_generation_is_stale(
                 const std::string& _object_path,
+                const std::string& _generation);
+
+            // the good replica cheapest to read from this server by the
+            // configured cost model, with a replica number of -1 when the
+            // object has no good replica and the choice is left to the server
+            replica_read_cost select_replica_for_reading(
+                const std::string& _object_path);
+
+            // the host of the good replica cheapest to read regardless of
+            // locality, where a full text job reads it from local storage, or
+            // empty when it is not known
+            std::string get_execution_host_for_object(
+                const std::string& _object_path);
+
+            // schedule a single job per metadata index of an object, carrying
+            // every avu added to and removed from it
+            void schedule_metadata_update(
+                const std::string&      _object_path,
+                const std::string&      _user_name,
+                const std::vector<avu>& _added,
+                const std::vector<avu>& _removed);
+
+            // after an object or collection has been renamed, rewrite the
+            // paths within indices which apply to both locations, purge from
+            // those left behind and index into those newly applying
+            void schedule_rename(
+                const std::string& _source_path,
+                const std::string& _destination_path,
+                bool               _is_collection,
+                const std::string& _user_name);
+
+            // merge the catalog with the documents of a full text index, then
+            // schedule index jobs for missing or stale objects and purge jobs
+            // for documents whose objects are no longer in the catalog
+            void reconcile_collection(
+                const std::string& _collection_name,
                 const std::string& _user_name,
                 const std::string& _indexer,
-                const std::string& _indexer_name,
-                const std::string& _indexer_type);
+                const std::string& _index_name,
+                const std::string& _index_type);
 
             void schedule_full_text_indexing_event(
                 const std::string& _object_path,
                 const std::string& _user_name,
-                const std::string& _source_resource);
+                const std::string& _source_resource,
+                rodsLong_t         _data_size = -1);
 
             void schedule_full_text_purge_event(
                 const std::string& _object_path,
@@ -67,8 +235,89 @@ namespace irods {
                 const std::string& _value = {},
                 const std::string& _units = {});
 
+            // schedule a set of buffered events, coalescing duplicates and
+            // batching whole object events which share an index
+            void schedule_indexing_events(
+                const std::vector<indexing_event>& _events);
+
             private:
-            std::string generate_delay_execution_parameters();
+            void schedule_subcollection_crawls(
+                const std::string&              _operation_type,
+                const std::vector<std::string>& _collection_names,
+                const std::string&              _user_name,
+                const std::string&              _indexer,
+                const std::string&              _index_name,
+                const std::string&              _index_type);
+
+            void schedule_collection_crawl(
+                const std::string&              _operation_type,
+                const std::vector<std::string>& _collection_names,
+                const std::string&              _user_name,
+                const std::string&              _indexer,
+                const std::string&              _index_name,
+                const std::string&              _index_type,
+                const std::string&              _continuation_token);
+
+            // schedules the objects of a collection with a data id greater than
+            // _last_data_id, stopping after _object_limit objects if non zero.
+            // returns false when stopped early, _last_data_id then holds the
+            // continuation token
+            bool schedule_policy_events_for_collection_objects(
+                const std::string& _operation_type,
+                const std::string& _collection_name,
+                bool               _recursive,
+                const std::string& _user_name,
+                const std::string& _indexer,
+                const std::string& _index_name,
+                const std::string& _index_type,
+                std::size_t        _object_limit,
+                std::string&       _last_data_id,
+                std::size_t&       _object_count,
+                std::size_t&       _visited_count);
+
+            std::string generate_delay_execution_parameters(
+                const std::string& _priority_class,
+                const std::string& _index_name,
+                std::size_t        _document_count,
+                rodsLong_t         _byte_count);
+
+            // a job writing to several indices is charged against each of
+            // them, and starts once all of them have capacity
+            std::string generate_delay_execution_parameters(
+                const std::string&              _priority_class,
+                const std::vector<std::string>& _index_names,
+                std::size_t                     _document_count,
+                rodsLong_t                      _byte_count);
+
+            // seconds until a job of the given size may start under the rate
+            // limit of the index, or -1 when the index is not limited
+            int reserve_index_capacity(
+                const std::string& _index_name,
+                std::size_t        _document_count,
+                rodsLong_t         _byte_count);
+
+            // full text index jobs whose objects are all archive only run in
+            // the bulk lane when so configured
+            std::string get_priority_class(
+                const std::string&              _operation_type,
+                const std::string&              _index_type,
+                rodsLong_t                      _data_size,
+                const std::vector<std::string>& _object_paths = {});
+
+            std::vector<replica_read_cost> get_replica_read_costs(
+                const std::string& _object_path);
+
+            // whether every good replica of the object resides on a resource
+            // costing at least the archive read cost
+            bool object_is_archive_only(
+                const std::string& _object_path);
+
+            // the type, location and read cost hint of every resource, from
+            // the per process resource cache
+            std::shared_ptr<const resource_property_map> get_resource_properties();
+
+            rodsLong_t get_data_size_for_object(
+                const std::string& _object_path);
 
             void schedule_policy_events_given_object_path(
                 const std::string& _operation_type,
@@ -78,7 +327,12 @@ namespace irods {
                 const std::string& _source_resource = {},
                 const std::string& _attribute = {},
                 const std::string& _value = {},
-                const std::string& _units = {});
+                const std::string& _units = {},
+                rodsLong_t         _data_size = -1);
+
+            std::vector<index_target> get_index_targets_for_object(
+                const std::string& _object_path,
+                const std::string& _index_type);
 
             void get_metadata_for_data_object(
                 const std::string& _meta_attr_name,
@@ -86,11 +340,34 @@ namespace irods {
                 std::string&       _value,
                 std::string&       _unit );
 
-            using metadata_results = std::vector<std::pair<std::string, std::string>>;
-            metadata_results
-            get_metadata_for_collection(
-                const std::string& _meta_attr_name,
-                const std::string& _collection_name);
+            using metadata_results = collection_trie::metadata_results;
+
+            // indexing metadata on _path and its ancestors, nearest first
+            metadata_results get_index_metadata_for_path(
+                const std::string& _path);
+
+            // apply _fcn to the trie of indexed collections, which is loaded
+            // when it has expired
+            metadata_results query_indexed_collections(
+                const std::function<metadata_results(const collection_trie&)>& _fcn);
+
+            void schedule_metadata_update_policy(
+                const std::string&      _object_path,
+                const std::string&      _user_name,
+                const std::string&      _indexer,
+                const std::string&      _index_name,
+                const std::vector<avu>& _added,
+                const std::vector<avu>& _removed);
+
+            void schedule_rename_policy(
+                const std::string& _policy_name,
+                const std::string& _source_path,
+                const std::string& _destination_path,
+                const std::string& _user_name,
+                const std::string& _indexer,
+                const std::string& _index_name,
+                const std::string& _index_type,
+                bool               _purge_destination);
 
             void schedule_policy_event_for_object(
                 const std::string& _event,
@@ -100,20 +377,40 @@ namespace irods {
                 const std::string& _indexer,
                 const std::string& _index_name,
                 const std::string& _index_type,
+                const std::string& _priority_class,
                 const std::string& _data_movement_params,
                 const std::string& _attribute = {},
                 const std::string& _value = {},
                 const std::string& _units = {});
 
-            std::vector<std::string> get_indexing_resource_names();
+            // a single full text index job reading the object once for every
+            // index of one technology
+            void schedule_multiple_index_event_for_object(
+                const std::string&              _object_path,
+                const std::string&              _user_name,
+                const std::string&              _source_resource,
+                const std::string&              _indexer,
+                const std::vector<std::string>& _index_names,
+                const std::string&              _priority_class,
+                const std::string&              _data_movement_params);
 
-            std::string get_indexing_resource_name_for_object(
-                const std::string        _object_path,
-                std::vector<std::string> _resource_names);
+            void schedule_policy_event_for_objects(
+                const std::string&              _event,
+                const std::vector<std::string>& _object_paths,
+                const std::string&              _user_name,
+                const std::string&              _source_resource,
+                const std::string&              _indexer,
+                const std::string&              _index_name,
+                const std::string&              _index_type,
+                const std::string&              _priority_class,
+                const std::string&              _data_movement_params,
+                const std::string&              _execution_host = {});
+
+            std::shared_ptr<const resource_name_set> get_indexing_resource_names();
 
             bool resource_is_indexable(
-                const std::string        _source_resource,
-                std::vector<std::string> _resource_names);
+                const std::string&       _source_resource,
+                const resource_name_set& _resource_names);
 
             std::tuple<std::string, std::string>
                 parse_indexer_string(
@@ -122,9 +419,7 @@ namespace irods {
             // Attributes
             ruleExecInfo_t*rei_;
             rsComm_t*      comm_;
-            configuration   config_;
-
-            const std::string EMPTY_RESOURCE_NAME{"EMPTY_RESOURCE_NAME"};
+            std::shared_ptr<const configuration> config_;
         }; // class indexer
     } // namespace indexing
 } // namespace irods
@@ -9,8 +9,10 @@
 #include "configuration.hpp"
 #include "dstream.hpp"
 #include "rsModAVUMetadata.hpp"
+#include "rsModDataObjMeta.hpp"
 #include "irods_hasher_factory.hpp"
 #include "MD5Strategy.hpp"
+#include "SHA256Strategy.hpp"
 
 #include "transport/default_transport.hpp"
 #include "filesystem.hpp"
@@ -22,6 +24,7 @@
 
 #include <boost/any.hpp>
 #include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -31,15 +34,30 @@
 #include <boost/archive/iterators/transform_width.hpp>
 #include <boost/archive/iterators/ostream_iterator.hpp>
 
+#include "json.hpp"
+
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
 
 namespace {
     struct configuration : irods::indexing::configuration {
         std::vector<std::string> hosts_;
         int                      bulk_count_{10};
         int                      read_size_{4194304};
+
+        // hash the content as it is read for indexing and register the
+        // checksum of replicas which have none
+        bool                     register_checksums_{false};
+        std::string              checksum_scheme_{irods::SHA256_NAME};
         configuration(const std::string& _instance_name) :
             irods::indexing::configuration(_instance_name) {
             try {
@@ -56,7 +74,15 @@ namespace {
                 }
 
                 if(cfg.find("read_size") != cfg.end()) {
-                    bulk_count_ = boost::any_cast<int>(cfg.at("read_size"));
+                    read_size_ = boost::any_cast<int>(cfg.at("read_size"));
+                }
+
+                if(cfg.find("register_checksums") != cfg.end()) {
+                    register_checksums_ = boost::any_cast<bool>(cfg.at("register_checksums"));
+                }
+
+                if(cfg.find("checksum_scheme") != cfg.end()) {
+                    checksum_scheme_ = boost::any_cast<std::string>(cfg.at("checksum_scheme"));
                 }
             }
             catch(const boost::bad_any_cast& _e) {
@@ -68,10 +94,19 @@ namespace {
     }; // configuration
 
     std::unique_ptr<configuration> config;
+    std::atomic<unsigned long long> unchanged_object_count{};
     std::string object_index_policy;
     std::string object_purge_policy;
+    std::string object_index_batch_policy;
+    std::string object_purge_batch_policy;
     std::string metadata_index_policy;
     std::string metadata_purge_policy;
+    std::string object_rename_policy;
+    std::string collection_rename_policy;
+    std::string collection_purge_policy;
+    std::string metadata_update_policy;
+    std::string object_index_multiple_policy;
+    std::string collection_list_policy;
 
     void apply_document_type_policy(
         ruleExecInfo_t*    _rei,
@@ -148,6 +183,660 @@ namespace {
 
     } // get_object_index_id
 
+    // the data id and latest modify time of an object, recorded with each
+    // full text document so the index may be reconciled with the catalog,
+    // and the fingerprint of the content from which it was indexed
+    struct object_index_info {
+        std::string data_id;
+        std::string modify_time{"0"};
+        std::string fingerprint;
+
+        // the size and modify time of the latest write, the fingerprint of an
+        // object without a checksum, which still identifies the content once
+        // one is registered
+        std::string content_stamp;
+    }; // struct object_index_info
+
+    object_index_info get_object_index_info(
+        ruleExecInfo_t*    _rei,
+        const std::string& _object_path) {
+        boost::filesystem::path p{_object_path};
+        std::string coll_name = p.parent_path().string();
+        std::string data_name = p.filename().string();
+        std::string query_str {
+            boost::str(
+                boost::format("SELECT DATA_ID, DATA_MODIFY_TIME, DATA_CHECKSUM, DATA_SIZE WHERE DATA_NAME = '%s' AND COLL_NAME = '%s'")
+                    % data_name
+                    % coll_name) };
+
+        object_index_info info;
+        std::string checksum, data_size;
+        try {
+            irods::query<rsComm_t> qobj{_rei->rsComm, query_str};
+            for(const auto& row : qobj) {
+                info.data_id = row[0];
+                if(row[1].size() > info.modify_time.size() ||
+                   (row[1].size() == info.modify_time.size() && row[1] >= info.modify_time)) {
+                    info.modify_time = row[1];
+                    data_size = row[3];
+                    if(!row[2].empty()) {
+                        checksum = row[2];
+                    }
+                }
+                else if(checksum.empty()) {
+                    checksum = row[2];
+                }
+            }
+        }
+        catch(const irods::exception&) {}
+
+        if(info.data_id.empty()) {
+            THROW(
+                CAT_NO_ROWS_FOUND,
+                boost::format("failed to get object id for [%s]")
+                % _object_path);
+        }
+
+        // replicas share a checksum, lacking one the size and the time of
+        // the latest write stand in for the content
+        info.content_stamp = data_size + ":" + info.modify_time;
+        info.fingerprint   = checksum.empty() ?
+                             info.content_stamp :
+                             checksum;
+
+        return info;
+    } // get_object_index_info
+
+    // what a job needs to know of the mapping of an index: the field by which
+    // documents are matched to the exact logical path of their object, and
+    // the document type already mapped, empty when there is none or several
+    struct index_mapping {
+        std::string path_field{"logical_path"};
+        std::string document_type;
+    }; // struct index_mapping
+
+    // per index and process
+    struct index_mapping_cache {
+        struct entry {
+            index_mapping                         mapping;
+            std::chrono::steady_clock::time_point expiration;
+        };
+
+        std::mutex                   mutex;
+        std::map<std::string, entry> entries;
+    } index_mappings;
+
+    // a recreated index is seen by long running processes within this time
+    const std::chrono::seconds index_mapping_lifetime{300};
+
+    // the type of a field, or of one of its subfields, within a mapping
+    std::string find_mapped_type(
+        const nlohmann::json& _properties,
+        const std::string&    _field,
+        const std::string&    _subfield = {}) {
+        const auto field = _properties.find(_field);
+        if(_properties.end() == field) {
+            return {};
+        }
+
+        if(_subfield.empty()) {
+            return field->value("type", std::string{});
+        }
+
+        const auto fields = field->find("fields");
+        if(field->end() == fields || fields->find(_subfield) == fields->end()) {
+            return {};
+        }
+
+        return fields->at(_subfield).value("type", std::string{});
+    } // find_mapped_type
+
+    // logical_path as mapped by the README, falling back to object_path for
+    // indices created before it was recorded, as every document carries it.
+    // an index matching neither exactly is refused rather than searched in
+    // vain
+    index_mapping get_index_mapping(
+        elasticlient::Client& _client,
+        const std::string&    _index_name) {
+        using json = nlohmann::json;
+        const auto now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock{index_mappings.mutex};
+            const auto itr = index_mappings.entries.find(_index_name);
+            if(index_mappings.entries.end() != itr && now < itr->second.expiration) {
+                return itr->second.mapping;
+            }
+        }
+
+        const cpr::Response response = _client.performRequest(
+                                           elasticlient::Client::HTTPMethod::GET,
+                                           _index_name + "/_mapping",
+                                           "");
+        // a missing index holds no documents to match, nor is it remembered
+        if(404 == response.status_code) {
+            return {};
+        }
+
+        if(response.status_code != 200) {
+            THROW(
+                SYS_INTERNAL_ERR,
+                boost::format("failed to get the mapping of [%s] code [%d] message [%s]")
+                % _index_name
+                % response.status_code
+                % response.text);
+        }
+
+        // properties are held per document type, or directly without types
+        index_mapping ret_val;
+        std::vector<json> mappings;
+        std::set<std::string> document_types;
+        for(const auto& index : json::parse(response.text)) {
+            const auto m = index.find("mappings");
+            if(index.end() == m) {
+                continue;
+            }
+
+            if(m->find("properties") != m->end()) {
+                mappings.push_back(m->at("properties"));
+                continue;
+            }
+
+            for(auto type = m->begin(); type != m->end(); ++type) {
+                if(type->is_object() && type->find("properties") != type->end()) {
+                    mappings.push_back(type->at("properties"));
+                    document_types.insert(type.key());
+                }
+            }
+        }
+
+        if(1 == document_types.size()) {
+            ret_val.document_type = *document_types.begin();
+        }
+
+        const auto mapped_by_all = [&](const std::string& _field, const std::string& _subfield) {
+            return !mappings.empty() &&
+                   std::all_of(
+                       mappings.begin(),
+                       mappings.end(),
+                       [&](const json& _p) { return "keyword" == find_mapped_type(_p, _field, _subfield); });
+        };
+
+        if(mapped_by_all("logical_path", {})) {
+            ret_val.path_field = "logical_path";
+        }
+        else if(mapped_by_all("object_path", {})) {
+            ret_val.path_field = "object_path";
+        }
+        else if(mapped_by_all("object_path", "keyword")) {
+            ret_val.path_field = "object_path.keyword";
+            rodsLog(
+                LOG_NOTICE,
+                "index [%s] has no logical_path keyword, matching paths by [%s] which ignores paths longer than 256 characters",
+                _index_name.c_str(),
+                ret_val.path_field.c_str());
+        }
+        else if(mappings.empty()) {
+            // nothing has been indexed yet, the first document maps the field
+            return ret_val;
+        }
+        else {
+            THROW(
+                SYS_INVALID_INPUT_PARAM,
+                boost::format("index [%s] maps neither logical_path nor object_path as a keyword, documents cannot be matched to their objects")
+                % _index_name);
+        }
+
+        std::lock_guard<std::mutex> lock{index_mappings.mutex};
+        index_mappings.entries[_index_name] = index_mapping_cache::entry{ret_val, now + index_mapping_lifetime};
+        return ret_val;
+    } // get_index_mapping
+
+    std::string get_path_field(
+        elasticlient::Client& _client,
+        const std::string&    _index_name) {
+        return get_index_mapping(_client, _index_name).path_field;
+    } // get_path_field
+
+    // remove the full text documents of the given objects, metadata
+    // documents which may share the index carry an attribute and are kept
+    void delete_full_text_documents(
+        elasticlient::Client&           _client,
+        const std::string&              _index_name,
+        const std::vector<std::string>& _object_paths) {
+        using json = nlohmann::json;
+        json query;
+        query["query"]["bool"]["filter"] = json::array({
+            json{{"terms", {{get_path_field(_client, _index_name), _object_paths}}}}});
+        query["query"]["bool"]["must_not"] = json::array({
+            json{{"exists", {{"field", "attribute"}}}}});
+
+        const cpr::Response response = _client.performRequest(
+                                           elasticlient::Client::HTTPMethod::POST,
+                                           _index_name + "/_delete_by_query?conflicts=proceed",
+                                           query.dump());
+        // a missing index has nothing to delete
+        if(response.status_code != 200 && response.status_code != 404) {
+            THROW(
+                SYS_INTERNAL_ERR,
+                boost::format("failed to delete documents for [%d] objects in [%s] code [%d] message [%s]")
+                % _object_paths.size()
+                % _index_name
+                % response.status_code
+                % response.text);
+        }
+    } // delete_full_text_documents
+
+    // a page of the full text documents for objects within a collection,
+    // one per object ordered by data id, as a json array
+    void list_full_text_documents(
+        const std::string& _collection_name,
+        const std::string& _index_name,
+        const std::string& _after_data_id,
+        int                _page_size,
+        std::string*       _results) {
+        using json = nlohmann::json;
+        const std::string prefix{"/" == _collection_name ? _collection_name : _collection_name + "/"};
+
+        elasticlient::Client client{config->hosts_};
+
+        json query;
+        query["size"]    = _page_size;
+        query["_source"] = json::array({"data_id", "modify_time", "object_path"});
+        query["sort"]    = json::array({json{{"data_id", "asc"}}});
+        query["query"]["bool"]["filter"] = json::array({
+            json{{"prefix", {{get_path_field(client, _index_name), prefix}}}},
+            json{{"term", {{"chunk_index", 0}}}},
+            json{{"range", {{"data_id", {{"gt", std::stoll(_after_data_id)}}}}}}});
+
+        const cpr::Response response = client.performRequest(
+                                           elasticlient::Client::HTTPMethod::POST,
+                                           _index_name + "/_search",
+                                           query.dump());
+        if(404 == response.status_code) {
+            *_results = "[]";
+            return;
+        }
+
+        if(response.status_code != 200) {
+            THROW(
+                SYS_INTERNAL_ERR,
+                boost::format("failed to list documents in [%s] for [%s] code [%d] message [%s]")
+                % _index_name
+                % _collection_name
+                % response.status_code
+                % response.text);
+        }
+
+        // the parsed response must outlive the loop over its hits
+        const auto result = json::parse(response.text);
+        json documents = json::array();
+        for(const auto& hit : result.at("hits").at("hits")) {
+            documents.push_back(hit.at("_source"));
+        }
+
+        *_results = documents.dump();
+    } // list_full_text_documents
+
+    // record a new modify time and fingerprint on the full text documents of
+    // an object whose content is unchanged, so reconciliation does not
+    // consider it stale and a checksum registered since is recorded
+    void update_full_text_fingerprint(
+        elasticlient::Client& _client,
+        const std::string&    _index_name,
+        const std::string&    _object_path,
+        const std::string&    _modify_time,
+        const std::string&    _fingerprint) {
+        using json = nlohmann::json;
+        json query;
+        query["query"]["bool"]["filter"] = json::array({
+            json{{"term", {{get_path_field(_client, _index_name), _object_path}}}}});
+        query["query"]["bool"]["must_not"] = json::array({
+            json{{"exists", {{"field", "attribute"}}}}});
+        query["script"]["source"] = "ctx._source.modify_time = params.modify_time; ctx._source.fingerprint = params.fingerprint";
+        query["script"]["params"]["modify_time"] = boost::lexical_cast<long long>(_modify_time);
+        query["script"]["params"]["fingerprint"] = _fingerprint;
+
+        const cpr::Response response = _client.performRequest(
+                                           elasticlient::Client::HTTPMethod::POST,
+                                           _index_name + "/_update_by_query?conflicts=proceed",
+                                           query.dump());
+        if(response.status_code != 200) {
+            THROW(
+                SYS_INTERNAL_ERR,
+                boost::format("failed to update fingerprint for [%s] in [%s] code [%d] message [%s]")
+                % _object_path
+                % _index_name
+                % response.status_code
+                % response.text);
+        }
+    } // update_full_text_fingerprint
+
+    // the full text documents already held for an object, from which it is
+    // known whether reindexing may leave stale chunks behind
+    struct indexed_documents {
+        std::set<std::string> data_ids;
+        long long             chunk_count{};
+    }; // struct indexed_documents
+
+    // the objects whose full text documents were indexed from the same data
+    // id and content fingerprint, which need not be read again, along with
+    // the documents held for every object
+    std::set<std::string> find_unchanged_objects(
+        elasticlient::Client&                           _client,
+        const std::string&                              _index_name,
+        const std::map<std::string, object_index_info>& _objects,
+        std::map<std::string, indexed_documents>*       _indexed = nullptr) {
+        using json = nlohmann::json;
+        std::set<std::string> unchanged;
+        if(_objects.empty()) {
+            return unchanged;
+        }
+
+        std::vector<std::string> object_paths;
+        for(const auto& o : _objects) {
+            object_paths.push_back(o.first);
+        }
+
+        const auto path_field = get_path_field(_client, _index_name);
+
+        // the aggregation sees every chunk, the hits only the first
+        json query;
+        query["size"]    = object_paths.size();
+        query["_source"] = json::array({"data_id", "fingerprint", "modify_time", "object_path"});
+        query["query"]["bool"]["filter"] = json::array({
+            json{{"terms", {{path_field, object_paths}}}}});
+        query["query"]["bool"]["must_not"] = json::array({
+            json{{"exists", {{"field", "attribute"}}}}});
+        query["post_filter"] = json{{"term", {{"chunk_index", 0}}}};
+        if(_indexed) {
+            query["aggs"]["objects"]["terms"] = json{{"field", path_field}, {"size", object_paths.size()}};
+            query["aggs"]["objects"]["aggs"]["data_ids"]["terms"] = json{{"field", "data_id"}, {"size", 2}};
+            query["aggs"]["objects"]["aggs"]["last_chunk"]["max"] = json{{"field", "chunk_index"}};
+        }
+
+        const cpr::Response response = _client.performRequest(
+                                           elasticlient::Client::HTTPMethod::POST,
+                                           _index_name + "/_search",
+                                           query.dump());
+        if(404 == response.status_code) {
+            return unchanged;
+        }
+
+        if(response.status_code != 200) {
+            THROW(
+                SYS_INTERNAL_ERR,
+                boost::format("failed to find indexed documents in [%s] code [%d] message [%s]")
+                % _index_name
+                % response.status_code
+                % response.text);
+        }
+
+        const auto result = json::parse(response.text);
+        if(_indexed && result.find("aggregations") != result.end()) {
+            for(const auto& bucket : result.at("aggregations").at("objects").at("buckets")) {
+                auto& documents = (*_indexed)[bucket.at("key").get<std::string>()];
+                for(const auto& id : bucket.at("data_ids").at("buckets")) {
+                    documents.data_ids.insert(std::to_string(id.at("key").get<long long>()));
+                }
+
+                const auto& last_chunk = bucket.at("last_chunk").at("value");
+                if(last_chunk.is_number()) {
+                    documents.chunk_count = static_cast<long long>(last_chunk.get<double>()) + 1;
+                }
+            }
+        }
+
+        // every document carries object_path, whichever field is matched
+        for(const auto& hit : result.at("hits").at("hits")) {
+            const auto& src = hit.at("_source");
+            const auto  itr = _objects.find(src.value("object_path", std::string{}));
+            if(_objects.end() == itr ||
+               std::to_string(src.value("data_id", 0LL)) != itr->second.data_id) {
+                continue;
+            }
+
+            // content indexed before its checksum was registered is known by
+            // its size and modify time until the fingerprint is brought up
+            const auto fingerprint = src.value("fingerprint", std::string{});
+            if(fingerprint != itr->second.fingerprint &&
+               fingerprint != itr->second.content_stamp) {
+                continue;
+            }
+
+            if(fingerprint != itr->second.fingerprint ||
+               src.value("modify_time", 0LL) != boost::lexical_cast<long long>(itr->second.modify_time)) {
+                update_full_text_fingerprint(
+                    _client,
+                    _index_name,
+                    itr->first,
+                    itr->second.modify_time,
+                    itr->second.fingerprint);
+            }
+
+            unchanged.insert(itr->first);
+            rodsLog(
+                LOG_DEBUG,
+                "skipping unchanged object [%s] in [%s], [%llu] skipped",
+                itr->first.c_str(),
+                _index_name.c_str(),
+                ++unchanged_object_count);
+        }
+
+        return unchanged;
+    } // find_unchanged_objects
+
+    // documents are written over by id, only chunks beyond the new count or
+    // those of an earlier object at the same path can outlive a reindex, and
+    // they are removed only when the index is known to hold any
+    void delete_stale_chunks(
+        elasticlient::Client&    _client,
+        const std::string&       _index_name,
+        const std::string&       _object_path,
+        const std::string&       _data_id,
+        long long                _chunk_count,
+        const indexed_documents& _indexed) {
+        using json = nlohmann::json;
+        const bool other_objects = _indexed.data_ids.size() > 1 ||
+                                   (1 == _indexed.data_ids.size() && _indexed.data_ids.count(_data_id) == 0);
+        if(!other_objects && _indexed.chunk_count <= _chunk_count) {
+            return;
+        }
+
+        json current;
+        current["bool"]["filter"] = json::array({
+            json{{"term", {{"data_id", boost::lexical_cast<long long>(_data_id)}}}},
+            json{{"range", {{"chunk_index", {{"lt", _chunk_count}}}}}}});
+
+        json query;
+        query["query"]["bool"]["filter"] = json::array({
+            json{{"term", {{get_path_field(_client, _index_name), _object_path}}}}});
+        query["query"]["bool"]["must_not"] = json::array({
+            json{{"exists", {{"field", "attribute"}}}},
+            current});
+
+        const cpr::Response response = _client.performRequest(
+                                           elasticlient::Client::HTTPMethod::POST,
+                                           _index_name + "/_delete_by_query?conflicts=proceed",
+                                           query.dump());
+        if(response.status_code != 200 && response.status_code != 404) {
+            THROW(
+                SYS_INTERNAL_ERR,
+                boost::format("failed to delete stale chunks of [%s] in [%s] code [%d] message [%s]")
+                % _object_path
+                % _index_name
+                % response.status_code
+                % response.text);
+        }
+    } // delete_stale_chunks
+
+    // rewrite the object path of every document for an object, or for the
+    // objects within a collection, leaving the content in place
+    void rename_documents(
+        const std::string& _source_path,
+        const std::string& _destination_path,
+        const std::string& _index_name,
+        bool               _is_collection) {
+        using json = nlohmann::json;
+        cpr::Response response;
+        try {
+            elasticlient::Client client{config->hosts_};
+            const auto path_field = get_path_field(client, _index_name);
+
+            // object_path is present on documents which predate logical_path
+            json query;
+            query["script"]["lang"] = "painless";
+            if(_is_collection) {
+                const std::string prefix{_source_path + "/"};
+                query["query"]["bool"]["filter"] = json::array({
+                    json{{"prefix", {{path_field, prefix}}}}});
+                // the source is measured by painless, whose strings count utf-16
+                // code units rather than bytes
+                query["script"]["source"] = "String p = params.destination + ctx._source.object_path.substring(params.source.length()); ctx._source.object_path = p; ctx._source.logical_path = p";
+                query["script"]["params"]["source"]      = _source_path;
+                query["script"]["params"]["destination"] = _destination_path;
+            }
+            else {
+                query["query"]["bool"]["filter"] = json::array({
+                    json{{"term", {{path_field, _source_path}}}}});
+                query["script"]["source"] = "ctx._source.object_path = params.destination; ctx._source.logical_path = params.destination";
+                query["script"]["params"]["destination"] = _destination_path;
+            }
+
+            response = client.performRequest(
+                           elasticlient::Client::HTTPMethod::POST,
+                           _index_name + "/_update_by_query?conflicts=proceed" +
+                           (_is_collection ? "&slices=auto" : ""),
+                           query.dump());
+        }
+        catch(const std::runtime_error& _e) {
+            THROW(
+                SYS_INTERNAL_ERR,
+                _e.what());
+        }
+
+        // a missing index has nothing to rename
+        if(response.status_code != 200 && response.status_code != 404) {
+            THROW(
+                SYS_INTERNAL_ERR,
+                boost::format("failed to rename [%s] to [%s] in [%s] code [%d] message [%s]")
+                % _source_path
+                % _destination_path
+                % _index_name
+                % response.status_code
+                % response.text);
+        }
+    } // rename_documents
+
+    // poll a task started without waiting for completion until it is done,
+    // backing off up to half a minute between polls
+    nlohmann::json wait_for_task(
+        elasticlient::Client& _client,
+        const std::string&    _task_id) {
+        using json = nlohmann::json;
+        std::chrono::seconds interval{1};
+        while(true) {
+            const cpr::Response response = _client.performRequest(
+                                               elasticlient::Client::HTTPMethod::GET,
+                                               "_tasks/" + _task_id,
+                                               "");
+            if(response.status_code != 200) {
+                THROW(
+                    SYS_INTERNAL_ERR,
+                    boost::format("failed to get task [%s] code [%d] message [%s]")
+                    % _task_id
+                    % response.status_code
+                    % response.text);
+            }
+
+            auto status = json::parse(response.text);
+            if(status.value("completed", false)) {
+                if(status.count("error") > 0) {
+                    THROW(
+                        SYS_INTERNAL_ERR,
+                        boost::format("task [%s] failed [%s]")
+                        % _task_id
+                        % status.at("error").dump());
+                }
+
+                return status.value("response", json::object());
+            }
+
+            std::this_thread::sleep_for(interval);
+            interval = std::min(interval * 2, std::chrono::seconds{30});
+        }
+    } // wait_for_task
+
+    // remove the documents of every object within a collection with a single
+    // sliced delete by query, tracked as a task to completion
+    void purge_collection_documents(
+        const std::string& _collection_name,
+        const std::string& _index_name,
+        const std::string& _index_type) {
+        using json = nlohmann::json;
+        const std::string prefix{"/" == _collection_name ? _collection_name : _collection_name + "/"};
+
+        try {
+            elasticlient::Client client{config->hosts_};
+
+            // metadata and full text documents may share an index, only the
+            // former carry an attribute
+            json query;
+            query["query"]["bool"]["filter"] = json::array({
+                json{{"prefix", {{get_path_field(client, _index_name), prefix}}}}});
+            const json has_attribute{{"exists", {{"field", "attribute"}}}};
+            if(irods::indexing::index_type::metadata == _index_type) {
+                query["query"]["bool"]["filter"].push_back(has_attribute);
+            }
+            else {
+                query["query"]["bool"]["must_not"] = json::array({has_attribute});
+            }
+
+            const cpr::Response response = client.performRequest(
+                                               elasticlient::Client::HTTPMethod::POST,
+                                               _index_name + "/_delete_by_query?conflicts=proceed&slices=auto&wait_for_completion=false",
+                                               query.dump());
+            // a missing index has nothing to delete
+            if(404 == response.status_code) {
+                return;
+            }
+
+            if(response.status_code != 200) {
+                THROW(
+                    SYS_INTERNAL_ERR,
+                    boost::format("failed to purge [%s] from [%s] code [%d] message [%s]")
+                    % _collection_name
+                    % _index_name
+                    % response.status_code
+                    % response.text);
+            }
+
+            const std::string task_id = json::parse(response.text).at("task");
+            const auto result = wait_for_task(client, task_id);
+            if(!result.value("failures", json::array()).empty()) {
+                THROW(
+                    SYS_INTERNAL_ERR,
+                    boost::format("failed to purge [%s] from [%s] task [%s] failures [%s]")
+                    % _collection_name
+                    % _index_name
+                    % task_id
+                    % result.at("failures").dump());
+            }
+
+            rodsLog(
+                LOG_DEBUG,
+                "purged [%lld] documents for [%s] from [%s] in task [%s]",
+                result.value("deleted", 0LL),
+                _collection_name.c_str(),
+                _index_name.c_str(),
+                task_id.c_str());
+        }
+        catch(const std::runtime_error& _e) {
+            THROW(
+                SYS_INTERNAL_ERR,
+                _e.what());
+        }
+    } // purge_collection_documents
+
     void update_object_metadata(
         ruleExecInfo_t*    _rei,
         const std::string& _object_path,
@@ -171,23 +860,234 @@ namespace {
         }
     } // update_object_metadata
 
-    void invoke_indexing_event_full_text(
+    void perform_bulk(
+        elasticlient::Bulk&              _bulk_indexer,
+        elasticlient::SameIndexBulkData& _bulk,
+        const std::string&               _description) {
+        auto error_count = _bulk_indexer.perform(_bulk);
+        if(error_count > 0) {
+            rodsLog(
+                LOG_ERROR,
+                "Encountered %d errors when indexing [%s]",
+                error_count,
+                _description.c_str());
+        }
+        _bulk.clear();
+    } // perform_bulk
+
+    // the modify time of a replica which has no checksum in the catalog, or
+    // empty when it has one or does not exist
+    std::string get_unchecksummed_replica_modify_time(
         ruleExecInfo_t*    _rei,
         const std::string& _object_path,
-        const std::string& _source_resource,
-        const std::string& _index_name) {
+        int                _replica_number) {
+        boost::filesystem::path p{_object_path};
+        std::string query_str {
+            boost::str(
+                boost::format("SELECT DATA_CHECKSUM, DATA_MODIFY_TIME WHERE DATA_NAME = '%s' AND COLL_NAME = '%s' AND DATA_REPL_NUM = '%d'")
+                    % p.filename().string()
+                    % p.parent_path().string()
+                    % _replica_number) };
+
+        irods::query<rsComm_t> qobj{_rei->rsComm, query_str};
+        for(const auto& row : qobj) {
+            if(row[0].empty()) {
+                return row[1];
+            }
+        }
+
+        return {};
+    } // get_unchecksummed_replica_modify_time
+
+    void register_replica_checksum(
+        ruleExecInfo_t*          _rei,
+        const std::string&       _object_path,
+        const object_index_info& _info,
+        int                      _replica_number,
+        const std::string&       _modify_time,
+        const std::string&       _checksum) {
+        dataObjInfo_t obj_info{};
+        rstrcpy(obj_info.objPath, _object_path.c_str(), MAX_NAME_LEN);
+        obj_info.dataId  = boost::lexical_cast<rodsLong_t>(_info.data_id);
+        obj_info.replNum = _replica_number;
+
+        // the modify time is kept, the size and modify time by which the
+        // documents were fingerprinted then still identify the content
+        keyValPair_t reg_param{};
+        addKeyVal(&reg_param, CHKSUM_KW, _checksum.c_str());
+        addKeyVal(&reg_param, DATA_MODIFY_KW, _modify_time.c_str());
+
+        modDataObjMeta_t mod_inp{};
+        mod_inp.dataObjInfo = &obj_info;
+        mod_inp.regParam    = &reg_param;
+        const int status = rsModDataObjMeta(_rei->rsComm, &mod_inp);
+        clearKeyVal(&reg_param);
+        if(status < 0) {
+            THROW(
+                status,
+                boost::format("failed to register checksum for [%s] replica [%d]")
+                % _object_path
+                % _replica_number);
+        }
+    } // register_replica_checksum
+
+    // the replica chosen by the indexing framework for an object, or -1
+    int get_replica_number(
+        const nlohmann::json& _replica_numbers,
+        const std::string&    _object_path) {
+        const auto itr = _replica_numbers.find(_object_path);
+        return itr == _replica_numbers.end() ? -1 : itr->get<int>();
+    } // get_replica_number
+
+    // read an object once, feeding each chunk to the bulk of every index,
+    // returns the number of chunks
+    int index_object_full_text(
+        ruleExecInfo_t*                                      _rei,
+        const std::string&                                   _object_path,
+        const std::string&                                   _source_resource,
+        const object_index_info&                             _info,
+        int                                                  _replica_number,
+        elasticlient::Client&                                _client,
+        elasticlient::Bulk&                                  _bulk_indexer,
+        const std::vector<elasticlient::SameIndexBulkData*>& _bulks) {
+        std::string doc_type{"text"};
+        apply_document_type_policy(
+            _rei,
+            _object_path,
+            _source_resource,
+            &doc_type);
+
+        // an index already mapping a single type receives documents of that
+        // type, as it holds no other, and any other the policy's
+        std::vector<std::string> doc_types;
+        for(auto bulk : _bulks) {
+            const auto mapped_type = get_index_mapping(_client, bulk->indexName()).document_type;
+            doc_types.push_back(mapped_type.empty() ? doc_type : mapped_type);
+        }
+
+        // the replica read must be known for its checksum to be registered
+        const std::string unchecksummed_modify_time =
+            config->register_checksums_ && _replica_number >= 0 ?
+            get_unchecksummed_replica_modify_time(_rei, _object_path, _replica_number) :
+            std::string{};
+
+        irods::Hasher hasher;
+        const bool compute_checksum = !unchecksummed_modify_time.empty() &&
+                                      irods::getHasher(config->checksum_scheme_, hasher).ok();
+
+        const long read_size{config->read_size_};
+        std::vector<char> read_buff(read_size);
+        irods::experimental::io::server::basic_transport<char> xport(*_rei->rsComm);
+
+        // without a chosen replica the server picks one
+        using irods::experimental::io::idstream;
+        std::unique_ptr<idstream> stream;
+        if(_replica_number >= 0) {
+            stream = std::make_unique<idstream>(
+                         xport,
+                         _object_path,
+                         irods::experimental::io::replica_number{_replica_number});
+        }
+        else {
+            stream = std::make_unique<idstream>(xport, _object_path);
+        }
+
+        auto& ds = *stream;
+
+        int chunk_counter{0};
+        while(ds) {
+            ds.read(read_buff.data(), read_size);
+            const auto read_count = ds.gcount();
+
+            // an empty object is still indexed as a single empty chunk
+            if(read_count <= 0 && chunk_counter > 0) {
+                break;
+            }
+
+            std::string data(read_buff.data(), std::max<std::streamsize>(read_count, 0));
+            if(compute_checksum) {
+                hasher.update(data);
+            }
+
+            // filter out new line characters
+            data.erase(
+                std::remove_if(
+                    data.begin(),
+                    data.end(),
+                [](wchar_t c) {return (std::iscntrl(c) || c == '"' || c == '\'' || c == '\\');}),
+            data.end());
+
+            std::string index_id{
+                            boost::str(
+                            boost::format(
+                            "%s_%d")
+                            % _info.data_id
+                            % chunk_counter)};
+
+            std::string payload{
+                            boost::str(
+                            boost::format(
+                            "{ \"object_path\" : \"%s\", \"logical_path\" : \"%s\", \"data_id\" : %s, \"chunk_index\" : %d, \"modify_time\" : %d, \"fingerprint\" : \"%s\", \"data\" : \"%s\" }")
+                            % _object_path
+                            % _object_path
+                            % _info.data_id
+                            % chunk_counter
+                            % boost::lexical_cast<long long>(_info.modify_time)
+                            % _info.fingerprint
+                            % data)};
+            ++chunk_counter;
+
+            for(std::size_t i = 0; i < _bulks.size(); ++i) {
+                bool done = _bulks[i]->indexDocument(doc_types[i], index_id, payload.data());
+                if(done) {
+                    // have reached bulk_count chunks
+                    perform_bulk(_bulk_indexer, *_bulks[i], _object_path);
+                }
+            }
+        } // while
+
+        // only content read through to the end is checksummed
+        if(!compute_checksum || ds.bad() || !ds.eof()) {
+            return chunk_counter;
+        }
+
+        // a replica written while it was read keeps whatever it has now
+        if(get_unchecksummed_replica_modify_time(_rei, _object_path, _replica_number) !=
+           unchecksummed_modify_time) {
+            return chunk_counter;
+        }
+
+        // the content is indexed regardless of whether the checksum sticks
+        std::string checksum;
+        hasher.digest(checksum);
+        try {
+            register_replica_checksum(_rei, _object_path, _info, _replica_number, unchecksummed_modify_time, checksum);
+            rodsLog(
+                config->log_level,
+                "registered checksum [%s] for [%s] replica [%d]",
+                checksum.c_str(),
+                _object_path.c_str(),
+                _replica_number);
+        }
+        catch(const irods::exception& _e) {
+            rodsLog(
+                LOG_ERROR,
+                "%s",
+                _e.what());
+        }
+
+        return chunk_counter;
+    } // index_object_full_text
+
+    void invoke_indexing_event_full_text(
+        ruleExecInfo_t*       _rei,
+        const std::string&    _object_path,
+        const std::string&    _source_resource,
+        const std::string&    _index_name,
+        const nlohmann::json& _replica_numbers) {
 
         try {
-            std::string doc_type{"text"};
-            apply_document_type_policy(
-                _rei,
-                _object_path,
-                _source_resource,
-                &doc_type);
-
-            const long read_size{config->read_size_};
             const int bulk_count{config->bulk_count_};
-            const std::string object_id{get_object_index_id(_rei, _object_path)};
 
             std::shared_ptr<elasticlient::Client> client =
                 std::make_shared<elasticlient::Client>(
@@ -195,66 +1095,100 @@ namespace {
             elasticlient::Bulk bulkIndexer(client);
             elasticlient::SameIndexBulkData bulk(_index_name, bulk_count);
 
-            char read_buff[read_size];
-            irods::experimental::io::server::basic_transport<char> xport(*_rei->rsComm);
-            irods::experimental::io::idstream ds{xport, _object_path};
-
-            int chunk_counter{0};
-            bool need_final_perform{false};
-            while(ds) {
-                ds.read(read_buff, read_size);
-                std::string data{read_buff};
-
-                // filter out new line characters
-                data.erase(
-                    std::remove_if(
-                        data.begin(),
-                        data.end(),
-                    [](wchar_t c) {return (std::iscntrl(c) || c == '"' || c == '\'' || c == '\\');}),
-                data.end());
-
-                std::string index_id{
-                                boost::str(
-                                boost::format(
-                                "%s_%d")
-                                % object_id
-                                % chunk_counter)};
-                ++chunk_counter;
-
-                std::string payload{
-                                boost::str(
-                                boost::format(
-                                "{ \"object_path\" : \"%s\", \"data\" : \"%s\" }")
-                                % _object_path
-                                % data)};
-
-                need_final_perform = true;
-                bool done = bulk.indexDocument(doc_type, index_id, payload.data());
-                if(done) {
-                    need_final_perform = false;
-                    // have reached bulk_count chunks
-                    auto error_count = bulkIndexer.perform(bulk);
-                    if(error_count > 0) {
-                        rodsLog(
-                            LOG_ERROR,
-                            "Encountered %d errors when indexing [%s]",
-                            error_count,
-                            _object_path.c_str());
-                    }
-                    bulk.clear();
+            const auto info = get_object_index_info(_rei, _object_path);
+            std::map<std::string, indexed_documents> indexed;
+            if(!find_unchanged_objects(*client, _index_name, {{_object_path, info}}, &indexed).empty()) {
+                return;
+            }
+
+            const int chunk_count = index_object_full_text(
+                                        _rei,
+                                        _object_path,
+                                        _source_resource,
+                                        info,
+                                        get_replica_number(_replica_numbers, _object_path),
+                                        *client,
+                                        bulkIndexer,
+                                        {&bulk});
+
+            if(!bulk.empty()) {
+                perform_bulk(bulkIndexer, bulk, _object_path);
+            }
+
+            // chunks of a longer previous version, or of an earlier object at
+            // this path, would otherwise outlive the new content
+            delete_stale_chunks(*client, _index_name, _object_path, info.data_id, chunk_count, indexed[_object_path]);
+        }
+        catch(const std::runtime_error& _e) {
+            rodsLog(
+                LOG_ERROR,
+                "Exception [%s]",
+                _e.what());
+            THROW(
+                SYS_INTERNAL_ERR,
+                _e.what());
+        }
+        catch(const std::exception& _e) {
+            rodsLog(
+                LOG_ERROR,
+                "Exception [%s]",
+                _e.what());
+            THROW(
+                SYS_INTERNAL_ERR,
+                _e.what());
+        }
+    } // invoke_indexing_event_full_text
+
+    void invoke_indexing_event_full_text_multiple(
+        ruleExecInfo_t*                 _rei,
+        const std::string&              _object_path,
+        const std::string&              _source_resource,
+        const std::vector<std::string>& _index_names,
+        const nlohmann::json&           _replica_numbers) {
+
+        try {
+            const int bulk_count{config->bulk_count_};
+
+            std::shared_ptr<elasticlient::Client> client =
+                std::make_shared<elasticlient::Client>(
+                    config->hosts_);
+            elasticlient::Bulk bulkIndexer(client);
+
+            // only the indices not already holding this content are fed
+            const auto info = get_object_index_info(_rei, _object_path);
+            std::vector<std::unique_ptr<elasticlient::SameIndexBulkData>> bulks;
+            std::vector<elasticlient::SameIndexBulkData*> targets;
+            std::map<std::string, std::map<std::string, indexed_documents>> indexed;
+            for(const auto& index_name : _index_names) {
+                if(!find_unchanged_objects(*client, index_name, {{_object_path, info}}, &indexed[index_name]).empty()) {
+                    continue;
                 }
-            } // while
 
-            if(need_final_perform) {
-                auto error_count = bulkIndexer.perform(bulk);
-                if(error_count > 0) {
-                    rodsLog(
-                        LOG_ERROR,
-                        "Encountered %d errors when indexing [%s]",
-                        error_count,
-                        _object_path.c_str());
+                bulks.push_back(std::make_unique<elasticlient::SameIndexBulkData>(index_name, bulk_count));
+                targets.push_back(bulks.back().get());
+            }
+
+            if(targets.empty()) {
+                return;
+            }
+
+            const int chunk_count = index_object_full_text(
+                                        _rei,
+                                        _object_path,
+                                        _source_resource,
+                                        info,
+                                        get_replica_number(_replica_numbers, _object_path),
+                                        *client,
+                                        bulkIndexer,
+                                        targets);
+
+            for(auto bulk : targets) {
+                if(!bulk->empty()) {
+                    perform_bulk(bulkIndexer, *bulk, _object_path);
                 }
-                bulk.clear();
+
+                const auto& index_name = bulk->indexName();
+                delete_stale_chunks(*client, index_name, _object_path, info.data_id, chunk_count, indexed[index_name][_object_path]);
             }
         }
         catch(const std::runtime_error& _e) {
@@ -275,7 +1209,106 @@ namespace {
                 SYS_INTERNAL_ERR,
                 _e.what());
         }
-    } // invoke_indexing_event_full_text
+    } // invoke_indexing_event_full_text_multiple
+
+    void invoke_indexing_event_full_text_batch(
+        ruleExecInfo_t*                 _rei,
+        const std::vector<std::string>& _object_paths,
+        const std::string&              _source_resource,
+        const std::string&              _index_name,
+        const nlohmann::json&           _replica_numbers) {
+
+        int error_count{};
+        try {
+            const int bulk_count{config->bulk_count_};
+
+            // a single client and bulk pipeline is shared by every object in the batch
+            std::shared_ptr<elasticlient::Client> client =
+                std::make_shared<elasticlient::Client>(
+                    config->hosts_);
+            elasticlient::Bulk bulkIndexer(client);
+            elasticlient::SameIndexBulkData bulk(_index_name, bulk_count);
+
+            std::map<std::string, object_index_info> objects;
+            for(const auto& object_path : _object_paths) {
+                try {
+                    objects[object_path] = get_object_index_info(_rei, object_path);
+                }
+                catch(const irods::exception& _e) {
+                    ++error_count;
+                    rodsLog(
+                        LOG_ERROR,
+                        "failed to index object [%s] - [%s]",
+                        object_path.c_str(),
+                        _e.what());
+                }
+            } // for object_path
+
+            std::map<std::string, indexed_documents> indexed;
+            for(const auto& object_path : find_unchanged_objects(*client, _index_name, objects, &indexed)) {
+                objects.erase(object_path);
+            }
+
+            // stale chunks are deleted once the bulk holding their
+            // replacements has been sent
+            std::map<std::string, int> chunk_counts;
+            for(const auto& o : objects) {
+                const auto& object_path = o.first;
+                try {
+                    chunk_counts[object_path] = index_object_full_text(
+                                                    _rei,
+                                                    object_path,
+                                                    _source_resource,
+                                                    o.second,
+                                                    get_replica_number(_replica_numbers, object_path),
+                                                    *client,
+                                                    bulkIndexer,
+                                                    {&bulk});
+                }
+                catch(const irods::exception& _e) {
+                    ++error_count;
+                    rodsLog(
+                        LOG_ERROR,
+                        "failed to index object [%s] - [%s]",
+                        object_path.c_str(),
+                        _e.what());
+                }
+                catch(const std::runtime_error& _e) {
+                    ++error_count;
+                    rodsLog(
+                        LOG_ERROR,
+                        "failed to index object [%s] - [%s]",
+                        object_path.c_str(),
+                        _e.what());
+                }
+            } // for object_path
+
+            if(!bulk.empty()) {
+                perform_bulk(bulkIndexer, bulk, _index_name);
+            }
+
+            for(const auto& c : chunk_counts) {
+                delete_stale_chunks(*client, _index_name, c.first, objects.at(c.first).data_id, c.second, indexed[c.first]);
+            }
+        }
+        catch(const std::exception& _e) {
+            rodsLog(
+                LOG_ERROR,
+                "Exception [%s]",
+                _e.what());
+            THROW(
+                SYS_INTERNAL_ERR,
+                _e.what());
+        }
+
+        if(error_count > 0) {
+            THROW(
+                SYS_INTERNAL_ERR,
+                boost::format("failed to index [%d] of [%d] objects")
+                % error_count
+                % _object_paths.size());
+        }
+    } // invoke_indexing_event_full_text_batch
 
     void invoke_purge_event_full_text(
         ruleExecInfo_t*    _rei,
@@ -284,34 +1317,12 @@ namespace {
         const std::string& _index_name) {
 
         try {
-            std::string doc_type{"text"};
-            apply_document_type_policy(
-                _rei,
-                _object_path,
-                _source_resource,
-                &doc_type);
-
-            const long read_size{config->read_size_};
-            const int bulk_count{config->bulk_count_};
-            const std::string object_id{get_object_index_id(_rei, _object_path)};
+            // documents are found by path, the object may already be gone
             elasticlient::Client client{config->hosts_};
-
-            int chunk_counter{0};
-
-            bool done{false};
-            while(!done) {
-                std::string index_id{
-                                boost::str(
-                                boost::format(
-                                "%s_%d")
-                                % object_id
-                                % chunk_counter)};
-                ++chunk_counter;
-                const cpr::Response response = client.remove(_index_name, doc_type, index_id);
-                if(response.status_code != 200) {
-                    done = true;
-                }
-            } // while
+            delete_full_text_documents(
+                client,
+                _index_name,
+                {_object_path});
         }
         catch(const std::runtime_error& _e) {
             rodsLog(
@@ -333,6 +1344,39 @@ namespace {
         }
     } // invoke_purge_event_full_text
 
+    void invoke_purge_event_full_text_batch(
+        ruleExecInfo_t*                 _rei,
+        const std::vector<std::string>& _object_paths,
+        const std::string&              _source_resource,
+        const std::string&              _index_name) {
+
+        try {
+            elasticlient::Client client{config->hosts_};
+            delete_full_text_documents(
+                client,
+                _index_name,
+                _object_paths);
+        }
+        catch(const std::runtime_error& _e) {
+            rodsLog(
+                LOG_ERROR,
+                "Exception [%s]",
+                _e.what());
+            THROW(
+                SYS_INTERNAL_ERR,
+                _e.what());
+        }
+        catch(const std::exception& _e) {
+            rodsLog(
+                LOG_ERROR,
+                "Exception [%s]",
+                _e.what());
+            THROW(
+                SYS_INTERNAL_ERR,
+                _e.what());
+        }
+    } // invoke_purge_event_full_text_batch
+
     std::string get_metadata_index_id(
         const std::string& _index_id,
         const std::string& _attribute,
@@ -374,7 +1418,8 @@ namespace {
             std::string payload{
                             boost::str(
                             boost::format(
-                            "{ \"object_path\":\"%s\", \"attribute\":\"%s\", \"value\":\"%s\", \"units\":\"%s\" }")
+                            "{ \"object_path\":\"%s\", \"logical_path\":\"%s\", \"attribute\":\"%s\", \"value\":\"%s\", \"units\":\"%s\" }")
+                            % _object_path
                             % _object_path
                             % _attribute
                             % _value
@@ -412,6 +1457,93 @@ namespace {
         }
     } // invoke_indexing_event_metadata
 
+    // index the added and delete the removed metadata documents of an object
+    // in a single bulk request
+    void invoke_update_event_metadata(
+        ruleExecInfo_t*    _rei,
+        const std::string& _object_path,
+        const std::string& _added,
+        const std::string& _removed,
+        const std::string& _index_name) {
+        using json = nlohmann::json;
+        const std::string object_id{get_object_index_id(_rei, _object_path)};
+
+        std::string body;
+        for(const auto& avu : json::parse(_removed)) {
+            const std::string id{
+                get_metadata_index_id(
+                    object_id,
+                    avu.at(0).get<std::string>(),
+                    avu.at(1).get<std::string>(),
+                    avu.at(2).get<std::string>())};
+            body += json{{"delete", {{"_type", "text"}, {"_id", id}}}}.dump() + "\n";
+        }
+
+        for(const auto& avu : json::parse(_added)) {
+            const std::string attribute = avu.at(0);
+            const std::string value     = avu.at(1);
+            const std::string units     = avu.at(2);
+            const std::string id{get_metadata_index_id(object_id, attribute, value, units)};
+            body += json{{"index", {{"_type", "text"}, {"_id", id}}}}.dump() + "\n";
+            body += json{
+                        {"object_path",  _object_path},
+                        {"logical_path", _object_path},
+                        {"attribute",    attribute},
+                        {"value",        value},
+                        {"units",        units}}.dump() + "\n";
+        }
+
+        if(body.empty()) {
+            return;
+        }
+
+        try {
+            elasticlient::Client client{config->hosts_};
+            const cpr::Response response = client.performRequest(
+                                               elasticlient::Client::HTTPMethod::POST,
+                                               _index_name + "/_bulk",
+                                               body);
+            if(response.status_code != 200) {
+                THROW(
+                    SYS_INTERNAL_ERR,
+                    boost::format("failed to update metadata for [%s] code [%d] message [%s]")
+                    % _object_path
+                    % response.status_code
+                    % response.text);
+            }
+
+            // deleting a document which was never indexed is not an error
+            int error_count{};
+            const auto result = json::parse(response.text);
+            for(const auto& item : result.at("items")) {
+                for(const auto& action : item.items()) {
+                    const int status = action.value().value("status", 0);
+                    if(status >= 300 && !("delete" == action.key() && 404 == status)) {
+                        ++error_count;
+                    }
+                }
+            }
+
+            if(error_count > 0) {
+                THROW(
+                    SYS_INTERNAL_ERR,
+                    boost::format("failed [%d] metadata updates for [%s] in [%s]")
+                    % error_count
+                    % _object_path
+                    % _index_name);
+            }
+        }
+        catch(const std::runtime_error& _e) {
+            rodsLog(
+                LOG_ERROR,
+                "Exception [%s]",
+                _e.what());
+            THROW(
+                SYS_INTERNAL_ERR,
+                _e.what());
+        }
+    } // invoke_update_event_metadata
+
     void invoke_purge_event_metadata(
         ruleExecInfo_t*    _rei,
         const std::string& _object_path,
@@ -477,12 +1609,36 @@ irods::error start(
     object_purge_policy = irods::indexing::policy::compose_policy_name(
                                irods::indexing::policy::object::purge,
                                "elasticsearch");
+    object_index_batch_policy = irods::indexing::policy::compose_policy_name(
+                               irods::indexing::policy::object::index_batch,
+                               "elasticsearch");
+    object_purge_batch_policy = irods::indexing::policy::compose_policy_name(
+                               irods::indexing::policy::object::purge_batch,
+                               "elasticsearch");
     metadata_index_policy = irods::indexing::policy::compose_policy_name(
                                irods::indexing::policy::metadata::index,
                                "elasticsearch");
     metadata_purge_policy = irods::indexing::policy::compose_policy_name(
                                irods::indexing::policy::metadata::purge,
                                "elasticsearch");
+    collection_list_policy = irods::indexing::policy::compose_policy_name(
+                               irods::indexing::policy::collection::list,
+                               "elasticsearch");
+    object_rename_policy = irods::indexing::policy::compose_policy_name(
+                               irods::indexing::policy::object::rename,
+                               "elasticsearch");
+    collection_rename_policy = irods::indexing::policy::compose_policy_name(
+                               irods::indexing::policy::collection::rename,
+                               "elasticsearch");
+    collection_purge_policy = irods::indexing::policy::compose_policy_name(
+                               irods::indexing::policy::collection::purge,
+                               "elasticsearch");
+    metadata_update_policy = irods::indexing::policy::compose_policy_name(
+                               irods::indexing::policy::metadata::update,
+                               "elasticsearch");
+    object_index_multiple_policy = irods::indexing::policy::compose_policy_name(
+                               irods::indexing::policy::object::index_multiple,
+                               "elasticsearch");
 
     elasticlient::setLogFunction(log_fcn);
     return SUCCESS();
@@ -498,10 +1654,18 @@ irods::error rule_exists(
     irods::default_re_ctx&,
     const std::string& _rn,
     bool&              _ret) {
-    _ret = object_index_policy   == _rn ||
-           object_purge_policy   == _rn ||
+    _ret = object_index_policy       == _rn ||
+           object_purge_policy       == _rn ||
+           object_index_batch_policy == _rn ||
+           object_purge_batch_policy == _rn ||
            metadata_index_policy == _rn ||
-           metadata_purge_policy == _rn;
+           metadata_purge_policy == _rn ||
+           collection_list_policy == _rn ||
+           object_rename_policy == _rn ||
+           collection_rename_policy == _rn ||
+           collection_purge_policy == _rn ||
+           metadata_update_policy == _rn ||
+           object_index_multiple_policy == _rn;
     return SUCCESS();
 }
 
@@ -510,8 +1674,16 @@ irods::error list_rules(
     std::vector<std::string>& _rules) {
     _rules.push_back(object_index_policy);
     _rules.push_back(object_purge_policy);
+    _rules.push_back(object_index_batch_policy);
+    _rules.push_back(object_purge_batch_policy);
     _rules.push_back(metadata_index_policy);
     _rules.push_back(metadata_purge_policy);
+    _rules.push_back(collection_list_policy);
+    _rules.push_back(object_rename_policy);
+    _rules.push_back(collection_rename_policy);
+    _rules.push_back(collection_purge_policy);
+    _rules.push_back(metadata_update_policy);
+    _rules.push_back(object_index_multiple_policy);
     return SUCCESS();
 }
 
@@ -532,12 +1704,34 @@ irods::error exec_rule(
             const std::string object_path{ boost::any_cast<std::string>(*it) }; ++it;
             const std::string source_resource{ boost::any_cast<std::string>(*it) }; ++it;
             const std::string index_name{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string index_type{ boost::any_cast<std::string>(*it) }; ++it;
+
+            // the replica to read is chosen by the framework when it can
+            const auto replica_numbers = it == _args.end() ?
+                                         nlohmann::json::object() :
+                                         nlohmann::json::parse(boost::any_cast<std::string>(*it));
 
             invoke_indexing_event_full_text(
                 rei,
                 object_path,
                 source_resource,
-                index_name);
+                index_name,
+                replica_numbers);
+        }
+        else if(_rn == object_index_multiple_policy) {
+            auto it = _args.begin();
+            const std::string object_path{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string source_resource{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string index_names{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string index_type{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string replica_numbers{ boost::any_cast<std::string>(*it) }; ++it;
+
+            invoke_indexing_event_full_text_multiple(
+                rei,
+                object_path,
+                source_resource,
+                nlohmann::json::parse(index_names).get<std::vector<std::string>>(),
+                nlohmann::json::parse(replica_numbers));
         }
         else if(_rn == object_purge_policy) {
             auto it = _args.begin();
@@ -551,6 +1745,36 @@ irods::error exec_rule(
                 source_resource,
                 index_name);
         }
+        else if(_rn == object_index_batch_policy) {
+            auto it = _args.begin();
+            const std::string object_paths{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string source_resource{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string index_name{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string index_type{ boost::any_cast<std::string>(*it) }; ++it;
+
+            const auto replica_numbers = it == _args.end() ?
+                                         nlohmann::json::object() :
+                                         nlohmann::json::parse(boost::any_cast<std::string>(*it));
+
+            invoke_indexing_event_full_text_batch(
+                rei,
+                nlohmann::json::parse(object_paths).get<std::vector<std::string>>(),
+                source_resource,
+                index_name,
+                replica_numbers);
+        }
+        else if(_rn == object_purge_batch_policy) {
+            auto it = _args.begin();
+            const std::string object_paths{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string source_resource{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string index_name{ boost::any_cast<std::string>(*it) }; ++it;
+
+            invoke_purge_event_full_text_batch(
+                rei,
+                nlohmann::json::parse(object_paths).get<std::vector<std::string>>(),
+                source_resource,
+                index_name);
+        }
         else if(_rn == metadata_index_policy) {
             auto it = _args.begin();
             const std::string object_path{ boost::any_cast<std::string>(*it) }; ++it;
@@ -584,6 +1808,58 @@ irods::error exec_rule(
                 index_name);
 
         }
+        else if(_rn == collection_list_policy) {
+            auto it = _args.begin();
+            const std::string collection_name{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string index_name{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string after_data_id{ boost::any_cast<std::string>(*it) }; ++it;
+            const int page_size{ boost::any_cast<int>(*it) }; ++it;
+            auto results = boost::any_cast<std::string*>(*it); ++it;
+
+            list_full_text_documents(
+                collection_name,
+                index_name,
+                after_data_id,
+                page_size,
+                results);
+        }
+        else if(_rn == object_rename_policy || _rn == collection_rename_policy) {
+            auto it = _args.begin();
+            const std::string source_path{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string destination_path{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string index_name{ boost::any_cast<std::string>(*it) }; ++it;
+
+            rename_documents(
+                source_path,
+                destination_path,
+                index_name,
+                _rn == collection_rename_policy);
+        }
+        else if(_rn == metadata_update_policy) {
+            auto it = _args.begin();
+            const std::string object_path{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string added{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string removed{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string index_name{ boost::any_cast<std::string>(*it) }; ++it;
+
+            invoke_update_event_metadata(
+                rei,
+                object_path,
+                added,
+                removed,
+                index_name);
+        }
+        else if(_rn == collection_purge_policy) {
+            auto it = _args.begin();
+            const std::string collection_name{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string index_name{ boost::any_cast<std::string>(*it) }; ++it;
+            const std::string index_type{ boost::any_cast<std::string>(*it) }; ++it;
+
+            purge_collection_documents(
+                collection_name,
+                index_name,
+                index_type);
+        }
         else {
             return ERROR(
                     SYS_NOT_SUPPORTED,
@@ -599,6 +1875,15 @@ irods::error exec_rule(
                    SYS_NOT_SUPPORTED,
                    _e.what());
     }
+    catch(const nlohmann::json::exception& _e) {
+        irods::indexing::exception_to_rerror(
+            SYS_INVALID_INPUT_PARAM,
+            _e.what(),
+            rei->rsComm->rError);
+        return ERROR(
+                   SYS_INVALID_INPUT_PARAM,
+                   _e.what());
+    }
     catch(const boost::bad_any_cast& _e) {
         irods::indexing::exception_to_rerror(
             INVALID_ANY_CAST,
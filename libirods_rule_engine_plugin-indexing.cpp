@@ -7,6 +7,11 @@
 #include "irods_resource_backport.hpp"
 #include "irods_query.hpp"
 #include "rsModAVUMetadata.hpp"
+#include "rcConnect.h"
+#include "dataObjCopy.h"
+
+#define IRODS_FILESYSTEM_ENABLE_SERVER_SIDE_API
+#include "filesystem.hpp"
 
 #include "utilities.hpp"
 #include "indexing_utilities.hpp"
@@ -19,6 +24,16 @@
 #include <sstream>
 #include <vector>
 #include <string>
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <set>
+#include <tuple>
+#include <cstdint>
+#include <string_view>
 
 // =-=-=-=-=-=-=-
 // boost includes
@@ -40,361 +55,1470 @@ int _delayExec(
 
 namespace {
     bool collection_metadata_is_new = false;
-    std::unique_ptr<irods::indexing::configuration>     config;
-    std::map<int, std::tuple<std::string, std::string>> opened_objects;
-
-    std::tuple<int, std::string>
-    get_index_and_resource(const dataObjInp_t* _inp) {
-        int l1_idx{};
-        dataObjInfo_t* obj_info{};
-        for(const auto& l1 : L1desc) {
-            if(FD_INUSE != l1.inuseFlag) {
-                continue;
-            }
-            if(!strcmp(l1.dataObjInp->objPath, _inp->objPath)) {
-                obj_info = l1.dataObjInfo;
-                l1_idx = &l1 - L1desc;
-            }
+
+    // index annotations an atomic metadata call is about to add to
+    // collections which do not already carry them, held from the pre to the
+    // post pep of the call by the connection making it along with the input
+    // of the call.  the finally pep drops them whether or not the call
+    // succeeded, and the post pep only takes those of its own input
+    using collection_annotation = std::tuple<std::string, std::string, std::string>;
+    struct pending_collection_annotations {
+        struct call {
+            std::string                     input;
+            std::set<collection_annotation> annotations;
+        };
+
+        std::mutex                      mutex;
+        std::map<const rsComm_t*, call> by_connection;
+    } new_collection_annotations;
+
+    // set once by start, the configuration itself may be replaced by a
+    // reload in another thread so it is fetched where it is used
+    std::string instance_name;
+    std::shared_ptr<const irods::indexing::configuration> get_config() {
+        return irods::indexing::get_configuration(instance_name);
+    }
+
+    // sizes of the replicas selected for reading by full text jobs run by
+    // this process, on this server and on others.  these are projected from
+    // the catalog as the job starts rather than counted as the bytes stream
+    std::atomic<rodsLong_t> local_bytes_selected{0};
+    std::atomic<rodsLong_t> remote_bytes_selected{0};
+
+    // objects open for write, indexed directly by their l1 descriptor
+    struct opened_object {
+        bool        in_use{};
+        std::string object_path;
+        std::string resource_name;
+        rodsLong_t  data_size{-1};
+    };
+
+    std::mutex                             opened_objects_mutex;
+    std::array<opened_object, NUM_L1_DESC> opened_objects;
+
+    void track_opened_object(const int _l1_idx) {
+        if(_l1_idx < 0 || _l1_idx >= NUM_L1_DESC) {
+            THROW(
+                SYS_FILE_DESC_OUT_OF_RANGE,
+                boost::format("invalid l1 descriptor [%d]")
+                % _l1_idx);
         }
 
-        if(nullptr == obj_info) {
+        const auto& l1 = L1desc[_l1_idx];
+        if(FD_INUSE != l1.inuseFlag ||
+           nullptr == l1.dataObjInp ||
+           nullptr == l1.dataObjInfo) {
             THROW(
                 SYS_INVALID_INPUT_PARAM,
                 "no object found");
         }
 
-        std::string resource_name;
-        irods::error err = irods::get_resource_property<std::string>(
-                               obj_info->rescId,
-                               irods::RESOURCE_NAME,
-                               resource_name);
-        if(!err.ok()) {
-            THROW(err.code(), err.result());
+        opened_object entry{};
+        const auto flags = l1.dataObjInp->openFlags;
+        if(flags & O_WRONLY || flags & O_RDWR) {
+            std::string resource_name;
+            irods::error err = irods::get_resource_property<std::string>(
+                                   l1.dataObjInfo->rescId,
+                                   irods::RESOURCE_NAME,
+                                   resource_name);
+            if(!err.ok()) {
+                THROW(err.code(), err.result());
+            }
+
+            entry.in_use        = true;
+            entry.object_path   = l1.dataObjInp->objPath;
+            entry.resource_name = resource_name;
+            // the catalog size is not updated until the close completes
+            entry.data_size     = std::max<rodsLong_t>(
+                                      l1.dataObjInfo->dataSize,
+                                      l1.bytesWritten);
+        }
+
+        // always overwrite the slot so a failed close leaves nothing stale
+        std::lock_guard<std::mutex> lock{opened_objects_mutex};
+        opened_objects[_l1_idx] = std::move(entry);
+    } // track_opened_object
+
+    bool release_opened_object(
+        const int      _l1_idx,
+        opened_object& _entry) {
+        if(_l1_idx < 0 || _l1_idx >= NUM_L1_DESC) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock{opened_objects_mutex};
+        auto& slot = opened_objects[_l1_idx];
+        if(!slot.in_use) {
+            return false;
+        }
+
+        _entry = std::move(slot);
+        slot   = opened_object{};
+        return true;
+    } // release_opened_object
+
+    // object events held by this agent until they are scheduled together
+    std::mutex                                   event_buffer_mutex;
+    std::vector<irods::indexing::indexing_event> event_buffer;
+    std::chrono::steady_clock::time_point        event_buffer_start;
+
+    // connection of this agent, used to hand off outstanding work at stop
+    rsComm_t* agent_comm{};
+
+    void flush_event_buffer(ruleExecInfo_t* _rei) {
+        std::vector<irods::indexing::indexing_event> events;
+        {
+            std::lock_guard<std::mutex> lock{event_buffer_mutex};
+            events.swap(event_buffer);
+        }
+
+        if(events.empty()) {
+            return;
         }
 
-        return std::make_tuple(l1_idx, resource_name);
-    } // get_object_path_and_resource
+        const auto start_time = std::chrono::steady_clock::now();
+
+        irods::indexing::indexer idx{_rei, instance_name};
+        idx.schedule_indexing_events(events);
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+        rodsLog(
+            get_config()->log_level,
+            "irods::indexing scheduled [%d] buffered events in [%f] seconds",
+            static_cast<int>(events.size()),
+            elapsed.count());
+    } // flush_event_buffer
+
+    void schedule_object_event(
+        ruleExecInfo_t*                 _rei,
+        irods::indexing::indexing_event _event) {
+        if(get_config()->event_buffer_size <= 0) {
+            irods::indexing::indexer idx{_rei, instance_name};
+            idx.schedule_indexing_events({_event});
+            return;
+        }
+
+        bool flush{false};
+        {
+            const auto now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock{event_buffer_mutex};
+            if(event_buffer.empty()) {
+                event_buffer_start = now;
+            }
+
+            event_buffer.push_back(std::move(_event));
+
+            flush = event_buffer.size() >= static_cast<std::size_t>(get_config()->event_buffer_size) ||
+                    now - event_buffer_start >= std::chrono::seconds(get_config()->event_buffer_flush_interval_in_seconds);
+        }
+
+        if(flush) {
+            flush_event_buffer(_rei);
+        }
+    } // schedule_object_event
 
 #define NULL_PTR_GUARD(x) ((x) == nullptr ? "" : (x))
 
-    void apply_indexing_policy(
-        const std::string &    _rn,
+    // the api input of a pep, its third parameter
+    template<typename T>
+    T get_pep_input(std::list<boost::any>& _args) {
+        auto it = _args.begin();
+        std::advance(it, 2);
+        if(_args.end() == it) {
+            THROW(
+                SYS_INVALID_INPUT_PARAM,
+                "invalid number of arguments");
+        }
+
+        return boost::any_cast<T>(*it);
+    } // get_pep_input
+
+    void handle_data_obj_put_post(
         ruleExecInfo_t*        _rei,
         std::list<boost::any>& _args) {
+        auto obj_inp = get_pep_input<dataObjInp_t*>(_args);
+        const std::string object_path{obj_inp->objPath};
+        const char* resc_hier = getValByKey(
+                                    &obj_inp->condInput,
+                                    RESC_HIER_STR_KW);
+        if(!resc_hier) {
+            THROW(SYS_INVALID_INPUT_PARAM, "resc hier is null");
+        }
+
+        std::string source_resource;
+        irods::hierarchy_parser parser;
+        parser.set_string(resc_hier);
+        parser.last_resc(source_resource);
+
+        irods::indexing::indexing_event event{
+            irods::indexing::operation_type::index,
+            irods::indexing::index_type::full_text,
+            object_path,
+            _rei->rsComm->clientUser.userName,
+            source_resource};
+        event.data_size = obj_inp->dataSize;
+        schedule_object_event(_rei, event);
+    } // handle_data_obj_put_post
+
+    void handle_data_obj_repl_post(
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        auto obj_inp = get_pep_input<dataObjInp_t*>(_args);
+        const std::string object_path{obj_inp->objPath};
+        const char* resc_hier = getValByKey(
+                                    &obj_inp->condInput,
+                                    DEST_RESC_HIER_STR_KW);
+        if(!resc_hier) {
+            THROW(SYS_INVALID_INPUT_PARAM, "resc hier is null");
+        }
+
+        std::string source_resource;
+        irods::hierarchy_parser parser;
+        parser.set_string(resc_hier);
+        parser.last_resc(source_resource);
+
+        // a replica holds the same content as its source, which needs no
+        // reading again if it was already indexed from another replica
+        irods::indexing::indexer idx{_rei, instance_name};
+        if(idx.object_has_indexed_replica(object_path, source_resource)) {
+            rodsLog(
+                get_config()->log_level,
+                "irods::indexing skipping replication of [%s] to [%s], already indexed",
+                object_path.c_str(),
+                source_resource.c_str());
+            return;
+        }
+
+        schedule_object_event(
+            _rei,
+            irods::indexing::indexing_event{
+                irods::indexing::operation_type::index,
+                irods::indexing::index_type::full_text,
+                object_path,
+                _rei->rsComm->clientUser.userName,
+                source_resource});
+    } // handle_data_obj_repl_post
+
+    void handle_data_obj_close_pre(
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        // the descriptor is still live, capture what the close will release
+        const auto opened_inp = get_pep_input<openedDataObjInp_t*>(_args);
         try {
-            std::string object_path;
-            std::string source_resource;
-            // NOTE:: 3rd parameter is the target
-            if("pep_api_data_obj_put_post"  == _rn) {
-                auto it = _args.begin();
-                std::advance(it, 2);
-                if(_args.end() == it) {
-                    THROW(
-                        SYS_INVALID_INPUT_PARAM,
-                        "invalid number of arguments");
+            track_opened_object(opened_inp->l1descInx);
+        }
+        catch(const irods::exception& _e) {
+            rodsLog(
+               LOG_ERROR,
+               "failed to track l1 descriptor [%d] - [%s]",
+               opened_inp->l1descInx,
+               _e.what());
+        }
+    } // handle_data_obj_close_pre
+
+    void handle_data_obj_close_post(
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        const auto opened_inp = get_pep_input<openedDataObjInp_t*>(_args);
+        opened_object entry{};
+        if(release_opened_object(opened_inp->l1descInx, entry)) {
+            irods::indexing::indexing_event event{
+                irods::indexing::operation_type::index,
+                irods::indexing::index_type::full_text,
+                entry.object_path,
+                _rei->rsComm->clientUser.userName,
+                entry.resource_name};
+            event.data_size = entry.data_size;
+            schedule_object_event(_rei, event);
+        }
+    } // handle_data_obj_close_post
+
+    void handle_mod_avu_metadata_pre(
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        const auto avu_inp = get_pep_input<modAVUMetadataInp_t*>(_args);
+        const std::string attribute{avu_inp->arg3};
+        if(get_config()->index != attribute) {
+            return;
+        }
+
+        const std::string operation{avu_inp->arg0};
+        const std::string type{avu_inp->arg1};
+        const std::string object_path{avu_inp->arg2};
+        const std::string add{"add"};
+        const std::string set{"set"};
+        const std::string collection{"-C"};
+
+        irods::indexing::indexer idx{_rei, instance_name};
+        if(operation == set || operation == add) {
+            if(type == collection) {
+                // was the added tag an indexing indicator
+                if(get_config()->index == attribute) {
+                    // verify that this is not new metadata with a query and set a flag
+                    if (!avu_inp->arg3) { THROW( SYS_INVALID_INPUT_PARAM, "empty metadata attribute" ); }
+                    if (!avu_inp->arg4) { THROW( SYS_INVALID_INPUT_PARAM, "empty metadata value" ); }
+                    collection_metadata_is_new = !idx.metadata_exists_on_collection(
+                                                     object_path,
+                                                     avu_inp->arg3,
+                                                     avu_inp->arg4,
+                                                     NULL_PTR_GUARD(avu_inp->arg5));
                 }
+            }
+        }
+    } // handle_mod_avu_metadata_pre
+
+    void handle_mod_avu_metadata_post(
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        const auto avu_inp = get_pep_input<modAVUMetadataInp_t*>(_args);
+        const std::string operation{avu_inp->arg0};
+        const std::string type{avu_inp->arg1};
+        const std::string collection_name{avu_inp->arg2};
+
+        // any resource metadata change may alter the indexing resources
+        const std::string resource{"-R"};
+        if(type == resource) {
+            irods::indexing::invalidate_indexing_resource_cache();
+        }
+
+        if (!avu_inp->arg3) { THROW( SYS_INVALID_INPUT_PARAM, "empty metadata attribute" ); }
+        if (!avu_inp->arg4) { THROW( SYS_INVALID_INPUT_PARAM, "empty metadata value" ); }
+        const std::string attribute{ avu_inp->arg3 };
+        const std::string value{ avu_inp->arg4 };
+        const std::string units{ NULL_PTR_GUARD(avu_inp->arg5) };
+
+        const std::string add{"add"};
+        const std::string set{"set"};
+        const std::string rm{"rm"};
+        const std::string collection{"-C"};
+        const std::string data_object{"-d"};
+
+        if(type == collection && get_config()->index == attribute) {
+            irods::indexing::update_indexed_collection_cache(
+                operation,
+                collection_name,
+                value,
+                units);
+        }
 
-                auto obj_inp = boost::any_cast<dataObjInp_t*>(*it);
-                object_path = obj_inp->objPath;
-                const char* resc_hier = getValByKey(
-                                            &obj_inp->condInput,
-                                            RESC_HIER_STR_KW);
-                if(!resc_hier) {
-                    THROW(SYS_INVALID_INPUT_PARAM, "resc hier is null");
+        irods::indexing::indexer idx{_rei, instance_name};
+        if(operation == rm) {
+            // removed index metadata from collection
+            if(type == collection) {
+                // was the removed tag an indexing indicator
+                if(get_config()->index == attribute) {
+                    // schedule a possible purge of all indexed data in collection
+                    idx.schedule_collection_operation(
+                        irods::indexing::operation_type::purge,
+                        collection_name,
+                        _rei->rsComm->clientUser.userName,
+                        value,
+                        units);
+                }
+            }
+            // removed a single indexed AVU on an object
+            if(type == data_object) {
+                // schedule an AVU purge
+                schedule_object_event(
+                    _rei,
+                    irods::indexing::indexing_event{
+                        irods::indexing::operation_type::purge,
+                        irods::indexing::index_type::metadata,
+                        collection_name,
+                        _rei->rsComm->clientUser.userName,
+                        irods::indexing::indexer::EMPTY_RESOURCE_NAME,
+                        attribute,
+                        value,
+                        units});
+            }
+        }
+        else if(operation == set || operation == add) {
+            if(type == collection) {
+                // was the added tag an indexing indicator
+                if(get_config()->index == attribute) {
+                    // check the verify flag
+                    if(collection_metadata_is_new) {
+                        idx.schedule_collection_operation(
+                            irods::indexing::operation_type::index,
+                            collection_name,
+                            _rei->rsComm->clientUser.userName,
+                            value,
+                            units);
+                    }
                 }
+            }
+            if(type == data_object) {
+                schedule_object_event(
+                    _rei,
+                    irods::indexing::indexing_event{
+                        irods::indexing::operation_type::index,
+                        irods::indexing::index_type::metadata,
+                        collection_name,
+                        _rei->rsComm->clientUser.userName,
+                        irods::indexing::indexer::EMPTY_RESOURCE_NAME,
+                        attribute,
+                        value,
+                        units});
+            }
+        }
+    } // handle_mod_avu_metadata_post
 
-                irods::hierarchy_parser parser;
-                parser.set_string(resc_hier);
-                parser.last_resc(source_resource);
+    void handle_data_obj_unlink_post(
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        const auto obj_inp = get_pep_input<dataObjInp_t*>(_args);
+        schedule_object_event(
+            _rei,
+            irods::indexing::indexing_event{
+                irods::indexing::operation_type::purge,
+                irods::indexing::index_type::full_text,
+                obj_inp->objPath,
+                _rei->rsComm->clientUser.userName,
+                irods::indexing::indexer::EMPTY_RESOURCE_NAME});
+    } // handle_data_obj_unlink_post
 
-                irods::indexing::indexer idx{_rei, config->instance_name_};
-                idx.schedule_full_text_indexing_event(
-                    object_path,
-                    _rei->rsComm->clientUser.userName,
-                    source_resource);
-            }
-            else if("pep_api_data_obj_repl_post" == _rn) {
-                auto it = _args.begin();
-                std::advance(it, 2);
-                if(_args.end() == it) {
-                    THROW(
-                        SYS_INVALID_INPUT_PARAM,
-                        "invalid number of arguments");
+    void handle_phy_path_reg_post(
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        const auto obj_inp = get_pep_input<dataObjInp_t*>(_args);
+
+        // a recursive registration is crawled as a whole, in batches, rather
+        // than raising an event for each registered file
+        if(getValByKey(&obj_inp->condInput, COLLECTION_KW)) {
+            irods::indexing::indexer idx{_rei, instance_name};
+            idx.schedule_registered_collection(
+                obj_inp->objPath,
+                _rei->rsComm->clientUser.userName);
+            return;
+        }
+
+        std::string source_resource{irods::indexing::indexer::EMPTY_RESOURCE_NAME};
+        const char* resc_hier = getValByKey(
+                                    &obj_inp->condInput,
+                                    RESC_HIER_STR_KW);
+        if(resc_hier) {
+            irods::hierarchy_parser parser;
+            parser.set_string(resc_hier);
+            parser.last_resc(source_resource);
+        }
+        else if(const char* resc_name = getValByKey(&obj_inp->condInput, DEST_RESC_NAME_KW)) {
+            source_resource = resc_name;
+        }
+
+        // single registrations coalesce in the event buffer when it is enabled
+        irods::indexing::indexing_event event{
+            irods::indexing::operation_type::index,
+            irods::indexing::index_type::full_text,
+            obj_inp->objPath,
+            _rei->rsComm->clientUser.userName,
+            source_resource};
+        if(obj_inp->dataSize > 0) {
+            event.data_size = obj_inp->dataSize;
+        }
+
+        schedule_object_event(_rei, event);
+    } // handle_phy_path_reg_post
+
+    void handle_data_obj_rename_post(
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        const auto copy_inp = get_pep_input<dataObjCopyInp_t*>(_args);
+        const std::string source_path{copy_inp->srcDataObjInp.objPath};
+        const std::string destination_path{copy_inp->destDataObjInp.objPath};
+
+        irods::indexing::indexer idx{_rei, instance_name};
+        bool is_collection{RENAME_COLL == copy_inp->srcDataObjInp.oprType};
+        if(RENAME_COLL != copy_inp->srcDataObjInp.oprType &&
+           RENAME_DATA_OBJ != copy_inp->srcDataObjInp.oprType) {
+            is_collection = irods::experimental::filesystem::server::is_collection(
+                                *_rei->rsComm,
+                                destination_path);
+        }
+
+        // annotated collections may have moved, the cached tree is stale
+        if(is_collection) {
+            irods::indexing::invalidate_indexed_collection_cache();
+        }
+
+        idx.schedule_rename(
+            source_path,
+            destination_path,
+            is_collection,
+            _rei->rsComm->clientUser.userName);
+    } // handle_data_obj_rename_post
+
+    nlohmann::json get_atomic_metadata_input(std::list<boost::any>& _args) {
+        const auto input = get_pep_input<bytesBuf_t*>(_args);
+        if(!input || !input->buf) {
+            THROW(SYS_INVALID_INPUT_PARAM, "atomic metadata input is null");
+        }
+
+        try {
+            return nlohmann::json::parse(
+                       std::string(static_cast<const char*>(input->buf), input->len));
+        }
+        catch(const nlohmann::json::exception& _e) {
+            THROW(SYS_INVALID_INPUT_PARAM, _e.what());
+        }
+    } // get_atomic_metadata_input
+
+    void handle_atomic_apply_metadata_operations_pre(
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        {
+            std::lock_guard<std::mutex> lock{new_collection_annotations.mutex};
+            new_collection_annotations.by_connection.erase(_rei->rsComm);
+        }
+
+        const auto input = get_atomic_metadata_input(_args);
+        if("collection" != input.at("entity_type").get<std::string>()) {
+            return;
+        }
+
+        const std::string collection_name = input.at("entity_name");
+        irods::indexing::indexer idx{_rei, instance_name};
+        std::set<collection_annotation> annotations;
+        for(const auto& op : input.at("operations")) {
+            const std::string attribute = op.at("attribute");
+            if("add" != op.at("operation").get<std::string>() || get_config()->index != attribute) {
+                continue;
+            }
+
+            const std::string value = op.at("value");
+            const std::string units = op.value("units", std::string{});
+            if(!idx.metadata_exists_on_collection(collection_name, attribute, value, units)) {
+                annotations.insert(std::make_tuple(collection_name, value, units));
+            }
+        }
+
+        if(annotations.empty()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{new_collection_annotations.mutex};
+        new_collection_annotations.by_connection[_rei->rsComm] = {input.dump(), std::move(annotations)};
+    } // handle_atomic_apply_metadata_operations_pre
+
+    void handle_atomic_apply_metadata_operations_post(
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        const auto input = get_atomic_metadata_input(_args);
+        const std::string entity_name = input.at("entity_name");
+        const std::string entity_type = input.at("entity_type");
+
+        // any resource metadata change may alter the indexing resources
+        if("resource" == entity_type) {
+            irods::indexing::invalidate_indexing_resource_cache();
+            return;
+        }
+
+        irods::indexing::indexer idx{_rei, instance_name};
+        if("collection" == entity_type) {
+            std::set<collection_annotation> annotations;
+            {
+                std::lock_guard<std::mutex> lock{new_collection_annotations.mutex};
+                const auto itr = new_collection_annotations.by_connection.find(_rei->rsComm);
+                if(itr != new_collection_annotations.by_connection.end()) {
+                    if(itr->second.input == input.dump()) {
+                        annotations = std::move(itr->second.annotations);
+                    }
+                    new_collection_annotations.by_connection.erase(itr);
+                }
+            }
+
+            for(const auto& op : input.at("operations")) {
+                const std::string attribute = op.at("attribute");
+                if(get_config()->index != attribute) {
+                    continue;
                 }
 
-                auto obj_inp = boost::any_cast<dataObjInp_t*>(*it);
-                object_path = obj_inp->objPath;
-                const char* resc_hier = getValByKey(
-                                            &obj_inp->condInput,
-                                            DEST_RESC_HIER_STR_KW);
-                if(!resc_hier) {
-                    THROW(SYS_INVALID_INPUT_PARAM, "resc hier is null");
+                const std::string operation = op.at("operation");
+                const std::string value     = op.at("value");
+                const std::string units     = op.value("units", std::string{});
+                irods::indexing::update_indexed_collection_cache(
+                    operation,
+                    entity_name,
+                    value,
+                    units);
+
+                if("add" == operation) {
+                    if(annotations.count(std::make_tuple(entity_name, value, units)) > 0) {
+                        idx.schedule_collection_operation(
+                            irods::indexing::operation_type::index,
+                            entity_name,
+                            _rei->rsComm->clientUser.userName,
+                            value,
+                            units);
+                    }
+                }
+                else if("remove" == operation) {
+                    idx.schedule_collection_operation(
+                        irods::indexing::operation_type::purge,
+                        entity_name,
+                        _rei->rsComm->clientUser.userName,
+                        value,
+                        units);
+                }
+            }
+
+            return;
+        }
+
+        if("data_object" != entity_type) {
+            return;
+        }
+
+        // operations apply in order, an avu removed then added again, or the
+        // reverse, nets to its final state
+        std::vector<irods::indexing::avu> added, removed;
+        for(const auto& op : input.at("operations")) {
+            const irods::indexing::avu triple{
+                op.at("attribute").get<std::string>(),
+                op.at("value").get<std::string>(),
+                op.value("units", std::string{})};
+            const bool add = "add" == op.at("operation").get<std::string>();
+            auto& into = add ? added : removed;
+            auto& from = add ? removed : added;
+            from.erase(std::remove(from.begin(), from.end(), triple), from.end());
+            if(std::find(into.begin(), into.end(), triple) == into.end()) {
+                into.push_back(triple);
+            }
+        }
+
+        idx.schedule_metadata_update(
+            entity_name,
+            _rei->rsComm->clientUser.userName,
+            added,
+            removed);
+    } // handle_atomic_apply_metadata_operations_post
+
+    // runs after the post pep, or in its place when the call failed
+    void handle_atomic_apply_metadata_operations_finally(
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        std::lock_guard<std::mutex> lock{new_collection_annotations.mutex};
+        new_collection_annotations.by_connection.erase(_rei->rsComm);
+    } // handle_atomic_apply_metadata_operations_finally
+
+    using pep_handler = void (*)(ruleExecInfo_t*, std::list<boost::any>&);
+
+    struct pep_entry {
+        std::string_view name;
+        pep_handler      handler;
+    }; // struct pep_entry
+
+    // rule_exists is asked about every pep of every api call on the server,
+    // so the handled peps are placed in a table by a hash which is perfect
+    // for this set of names, found at compile time
+    constexpr std::array<pep_entry, 12> peps{{
+        {"pep_api_data_obj_put_post",     handle_data_obj_put_post},
+        {"pep_api_data_obj_repl_post",    handle_data_obj_repl_post},
+        {"pep_api_data_obj_close_pre",    handle_data_obj_close_pre},
+        {"pep_api_data_obj_close_post",   handle_data_obj_close_post},
+        {"pep_api_mod_avu_metadata_pre",  handle_mod_avu_metadata_pre},
+        {"pep_api_mod_avu_metadata_post", handle_mod_avu_metadata_post},
+        {"pep_api_data_obj_unlink_post",  handle_data_obj_unlink_post},
+        {"pep_api_phy_path_reg_post",     handle_phy_path_reg_post},
+        {"pep_api_data_obj_rename_post",  handle_data_obj_rename_post},
+        {"pep_api_atomic_apply_metadata_operations_pre",  handle_atomic_apply_metadata_operations_pre},
+        {"pep_api_atomic_apply_metadata_operations_post", handle_atomic_apply_metadata_operations_post},
+        {"pep_api_atomic_apply_metadata_operations_finally", handle_atomic_apply_metadata_operations_finally}}};
+
+    constexpr std::size_t pep_table_size{64};
+
+    constexpr std::uint64_t pep_hash(
+        std::string_view _name,
+        std::uint64_t    _seed) {
+        // fnv-1a
+        std::uint64_t hash{14695981039346656037ull ^ _seed};
+        for(const char c : _name) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    } // pep_hash
+
+    constexpr std::uint64_t max_pep_seed{1024};
+
+    constexpr std::uint64_t find_pep_seed() {
+        for(std::uint64_t seed = 0; seed < max_pep_seed; ++seed) {
+            std::array<bool, pep_table_size> used{};
+            bool perfect{true};
+            for(const auto& pep : peps) {
+                auto& slot = used[pep_hash(pep.name, seed) % pep_table_size];
+                if(slot) {
+                    perfect = false;
+                    break;
                 }
+                slot = true;
+            }
+
+            if(perfect) {
+                return seed;
+            }
+        }
+
+        return max_pep_seed;
+    } // find_pep_seed
+
+    constexpr std::uint64_t pep_seed{find_pep_seed()};
+    static_assert(pep_seed < max_pep_seed, "no perfect hash for the pep table, increase pep_table_size");
+
+    constexpr std::array<pep_entry, pep_table_size> make_pep_table() {
+        std::array<pep_entry, pep_table_size> table{};
+        for(const auto& pep : peps) {
+            table[pep_hash(pep.name, pep_seed) % pep_table_size] = pep;
+        }
+
+        return table;
+    } // make_pep_table
+
+    constexpr auto pep_table = make_pep_table();
+
+    // the handler of a pep, null for any pep this plugin does not handle
+    pep_handler find_pep_handler(std::string_view _rn) {
+        const auto& entry = pep_table[pep_hash(_rn, pep_seed) % pep_table_size];
+        return entry.name == _rn ? entry.handler : nullptr;
+    } // find_pep_handler
+
+    void apply_indexing_policy(
+        const std::string &    _rn,
+        ruleExecInfo_t*        _rei,
+        std::list<boost::any>& _args) {
+        const auto handler = find_pep_handler(_rn);
+        if(!handler) {
+            return;
+        }
+
+        try {
+            handler(_rei, _args);
+        }
+        catch(const boost::bad_any_cast& _e) {
+            THROW(
+                INVALID_ANY_CAST,
+                boost::str(boost::format(
+                    "function [%s] rule name [%s]")
+                    % __FUNCTION__ % _rn));
+        }
+    } // apply_indexing_policy
+
+    void apply_object_policy(
+        ruleExecInfo_t*    _rei,
+        const std::string& _policy_root,
+        const std::string& _object_path,
+        const std::string& _source_resource,
+        const std::string& _indexer,
+        const std::string& _index_name,
+        const std::string& _index_type,
+        const std::string& _replica_numbers = {}) {
+        const std::string policy_name{irods::indexing::policy::compose_policy_name(
+                              _policy_root,
+                              _indexer)};
+
+        std::list<boost::any> args;
+        args.push_back(boost::any(_object_path));
+        args.push_back(boost::any(_source_resource));
+        args.push_back(boost::any(_index_name));
+        args.push_back(boost::any(_index_type));
+        if(!_replica_numbers.empty()) {
+            args.push_back(boost::any(_replica_numbers));
+        }
+        irods::indexing::invoke_policy(_rei, policy_name, args);
+
+    } // apply_object_policy
+
+    // a technology lacking the multiple index policy reads the object once
+    // per index instead
+    void apply_object_multiple_policy(
+        ruleExecInfo_t*                 _rei,
+        const std::string&              _object_path,
+        const std::string&              _source_resource,
+        const std::string&              _indexer,
+        const std::vector<std::string>& _index_names,
+        const std::string&              _replica_numbers) {
+        using json = nlohmann::json;
+        const std::string policy_name{irods::indexing::policy::compose_policy_name(
+                              irods::indexing::policy::object::index_multiple,
+                              _indexer)};
+        if(!irods::indexing::policy_exists(_rei, policy_name)) {
+            for(const auto& index_name : _index_names) {
+                apply_object_policy(
+                    _rei,
+                    irods::indexing::policy::object::index,
+                    _object_path,
+                    _source_resource,
+                    _indexer,
+                    index_name,
+                    irods::indexing::index_type::full_text,
+                    _replica_numbers);
+            }
+            return;
+        }
+
+        std::list<boost::any> args;
+        args.push_back(boost::any(_object_path));
+        args.push_back(boost::any(_source_resource));
+        args.push_back(boost::any(json(_index_names).dump()));
+        args.push_back(boost::any(irods::indexing::index_type::full_text));
+        args.push_back(boost::any(_replica_numbers));
+        irods::indexing::invoke_policy(_rei, policy_name, args);
+
+    } // apply_object_multiple_policy
+
+    void apply_object_batch_policy(
+        ruleExecInfo_t*                 _rei,
+        const std::string&              _policy_root,
+        const std::vector<std::string>& _object_paths,
+        const std::string&              _source_resource,
+        const std::string&              _indexer,
+        const std::string&              _index_name,
+        const std::string&              _index_type,
+        const std::string&              _replica_numbers = {}) {
+        using json = nlohmann::json;
+        const std::string policy_name{irods::indexing::policy::compose_policy_name(
+                              _policy_root,
+                              _indexer)};
+
+        // the object list is handed to the technology as a json array
+        std::list<boost::any> args;
+        args.push_back(boost::any(json(_object_paths).dump()));
+        args.push_back(boost::any(_source_resource));
+        args.push_back(boost::any(_index_name));
+        args.push_back(boost::any(_index_type));
+        if(!_replica_numbers.empty()) {
+            args.push_back(boost::any(_replica_numbers));
+        }
+        irods::indexing::invoke_policy(_rei, policy_name, args);
+
+    } // apply_object_batch_policy
 
-                irods::hierarchy_parser parser;
-                parser.set_string(resc_hier);
-                parser.last_resc(source_resource);
+    void apply_metadata_policy(
+        ruleExecInfo_t*    _rei,
+        const std::string& _policy_root,
+        const std::string& _object_path,
+        const std::string& _indexer,
+        const std::string& _index_name,
+        const std::string& _attribute,
+        const std::string& _value,
+        const std::string& _units) {
+        const std::string policy_name{irods::indexing::policy::compose_policy_name(
+                              _policy_root,
+                              _indexer)};
 
-                irods::indexing::indexer idx{_rei, config->instance_name_};
-                idx.schedule_full_text_indexing_event(
+        if(_attribute.empty() && _value.empty()) {
+            const boost::filesystem::path p{_object_path};
+            const std::string coll_name = p.parent_path().string();
+            const std::string data_name = p.filename().string();
+            const std::string query_str {
+                boost::str(
+                    boost::format("SELECT META_DATA_ATTR_NAME, META_DATA_ATTR_VALUE, META_DATA_ATTR_UNITS WHERE DATA_NAME = '%s' AND COLL_NAME = '%s'")
+                        % data_name
+                        % coll_name) };
+            irods::query<rsComm_t> qobj{_rei->rsComm, query_str};
+            for (const auto& result : qobj) {
+                std::list<boost::any> args;
+                args.push_back(boost::any(_object_path));
+                args.push_back(boost::any(result[0]));
+                args.push_back(boost::any(result[1]));
+                args.push_back(boost::any(result[2]));
+                args.push_back(boost::any(_index_name));
+                irods::indexing::invoke_policy(_rei, policy_name, args);
+            } // for
+        }
+        else {
+            std::list<boost::any> args;
+            args.push_back(boost::any(_object_path));
+            args.push_back(boost::any(_attribute));
+            args.push_back(boost::any(_value));
+            args.push_back(boost::any(_units));
+            args.push_back(boost::any(_index_name));
+            irods::indexing::invoke_policy(_rei, policy_name, args);
+        }
+    } // apply_metadata_policy
+
+    void apply_metadata_batch_policy(
+        ruleExecInfo_t*                 _rei,
+        const std::string&              _policy_root,
+        const std::vector<std::string>& _object_paths,
+        const std::string&              _indexer,
+        const std::string&              _index_name) {
+        int error_count{};
+        for(const auto& object_path : _object_paths) {
+            try {
+                apply_metadata_policy(
+                    _rei,
+                    _policy_root,
                     object_path,
+                    _indexer,
+                    _index_name,
+                    {},
+                    {},
+                    {});
+            }
+            catch(const irods::exception& _e) {
+                ++error_count;
+                rodsLog(
+                    LOG_ERROR,
+                    "failed to apply [%s] to object [%s] - [%s]",
+                    _policy_root.c_str(),
+                    object_path.c_str(),
+                    _e.what());
+            }
+        } // for object_path
+
+        if(error_count > 0) {
+            THROW(
+                SYS_INTERNAL_ERR,
+                boost::format("[%s] failed for [%d] of [%d] objects")
+                % _policy_root
+                % error_count
+                % _object_paths.size());
+        }
+    } // apply_metadata_batch_policy
+
+    // a crawl scheduled at a pep names one collection, a crawl scheduled by
+    // another crawl names several
+    std::vector<std::string> get_collection_names(
+        const nlohmann::json& _rule_obj) {
+        if(_rule_obj.count("collection-names") > 0) {
+            return _rule_obj["collection-names"].get<std::vector<std::string>>();
+        }
+
+        return {_rule_obj["collection-name"].get<std::string>()};
+    } // get_collection_names
+
+    // the replica each object is read from by a full text index job, as a
+    // json object of path to replica number handed to the technology
+    std::string select_replicas_for_reading(
+        ruleExecInfo_t*                 _rei,
+        const std::vector<std::string>& _object_paths,
+        const std::string&              _index_type) {
+        if(irods::indexing::index_type::full_text != _index_type) {
+            return {};
+        }
+
+        irods::indexing::indexer idx{_rei, instance_name};
+        nlohmann::json replicas = nlohmann::json::object();
+        rodsLong_t local_bytes{0};
+        rodsLong_t remote_bytes{0};
+        for(const auto& object_path : _object_paths) {
+            const auto replica = idx.select_replica_for_reading(object_path);
+            if(replica.replica_number < 0) {
+                continue;
+            }
+
+            replicas[object_path] = replica.replica_number;
+            (replica.remote ? remote_bytes : local_bytes) += replica.data_size;
+        }
+
+        rodsLog(
+            get_config()->log_level,
+            "irods::indexing selected replicas of [%lld] local and [%lld] remote bytes for [%d] objects, [%lld] local and [%lld] remote in total",
+            static_cast<long long>(local_bytes),
+            static_cast<long long>(remote_bytes),
+            static_cast<int>(_object_paths.size()),
+            static_cast<long long>(local_bytes_selected += local_bytes),
+            static_cast<long long>(remote_bytes_selected += remote_bytes));
+
+        return replicas.dump();
+    } // select_replicas_for_reading
+
+    // whether a full text job records a generation of its object older than
+    // the current one
+    bool job_is_superseded(
+        ruleExecInfo_t*       _rei,
+        const nlohmann::json& _rule_obj) {
+        const auto generation_itr = _rule_obj.find("object-generation");
+        if(generation_itr == _rule_obj.end()) {
+            return false;
+        }
+
+        const std::string object_path = _rule_obj.at("object-path");
+        irods::indexing::indexer idx{_rei, instance_name};
+        if(!idx.object_generation_is_stale(object_path, *generation_itr)) {
+            return false;
+        }
+
+        rodsLog(
+            LOG_NOTICE,
+            "irods::indexing job for [%s] superseded by a later write, skipping",
+            object_path.c_str());
+
+        return true;
+    } // job_is_superseded
+
+    // hand a job to the host of its data, returns false when the job is to
+    // run here.  batches are tagged with the host as they are split, single
+    // object jobs find it as they start rather than in the pep which
+    // scheduled them
+    bool forward_job_to_execution_host(
+        ruleExecInfo_t*       _rei,
+        const nlohmann::json& _rule_obj) {
+        std::string host;
+        const auto host_itr = _rule_obj.find("execution-host");
+        if(host_itr != _rule_obj.end()) {
+            host = host_itr->get<std::string>();
+        }
+        else {
+            const std::string operation = _rule_obj.value("rule-engine-operation", "");
+            const bool full_text_object =
+                (irods::indexing::policy::object::index == operation &&
+                 irods::indexing::index_type::full_text == _rule_obj.value("index-type", "")) ||
+                irods::indexing::policy::object::index_multiple == operation;
+            if(!get_config()->execute_near_data || !full_text_object) {
+                return false;
+            }
+
+            irods::indexing::indexer idx{_rei, instance_name};
+            host = idx.get_execution_host_for_object(_rule_obj.at("object-path"));
+        }
+
+        if(host.empty() || irods::indexing::host_is_local(host)) {
+            return false;
+        }
+
+        // a host which cannot be reached leaves the job to remote reads
+        rcComm_t* comm = irods::indexing::connect_to_server(host);
+        if(!comm) {
+            return false;
+        }
+
+        // an empty host runs the job wherever it arrives
+        auto forwarded = _rule_obj;
+        forwarded["execution-host"] = "";
+        forwarded.erase("object-generation");
+        const int status = irods::indexing::execute_rule_text(
+                               comm,
+                               instance_name,
+                               forwarded.dump());
+        rcDisconnect(comm);
+        if(status < 0) {
+            THROW(
+                status,
+                boost::format("failed to execute job on [%s]")
+                % host);
+        }
+
+        rodsLog(
+            get_config()->log_level,
+            "irods::indexing executed job on [%s]",
+            host.c_str());
+
+        return true;
+    } // forward_job_to_execution_host
+
+    // run a job scheduled by the indexer, whether it arrives from the delay
+    // server or from a worker pool thread
+    irods::error execute_indexing_job(
+        ruleExecInfo_t*       _rei,
+        const nlohmann::json& _rule_obj) {
+        irods::indexing::disable_worker_pool();
+
+        // long running processes such as the delay server pick up an edit
+        // of server_config.json as their next job starts
+        irods::indexing::refresh_configuration(instance_name);
+
+        // a full text job superseded by a later write of its object is
+        // skipped, the job scheduled for that write indexes the content
+        try {
+            if(job_is_superseded(_rei, _rule_obj)) {
+                return SUCCESS();
+            }
+        }
+        catch(const irods::exception& _e) {
+            rodsLog(
+                LOG_ERROR,
+                "irods::indexing failed to check the generation of [%s] - [%s]",
+                _rule_obj.value("object-path", "").c_str(),
+                _e.what());
+        }
+
+        try {
+            if(forward_job_to_execution_host(_rei, _rule_obj)) {
+                return SUCCESS();
+            }
+        }
+        catch(const irods::exception& _e) {
+            return ERROR(
+                    _e.code(),
+                    _e.what());
+        }
+
+        if(irods::indexing::policy::object::index ==
+           _rule_obj["rule-engine-operation"]) {
+            try {
+                // proxy for provided user name
+                const std::string& user_name = _rule_obj["user-name"];
+                rstrcpy(
+                    _rei->rsComm->clientUser.userName,
+                    user_name.c_str(),
+                    NAME_LEN);
+
+                const std::string object_path = _rule_obj["object-path"];
+                apply_object_policy(
+                    _rei,
+                    irods::indexing::policy::object::index,
+                    object_path,
+                    _rule_obj["source-resource"],
+                    _rule_obj["indexer"],
+                    _rule_obj["index-name"],
+                    _rule_obj["index-type"],
+                    select_replicas_for_reading(
+                        _rei,
+                        {object_path},
+                        _rule_obj["index-type"]));
+            }
+            catch(const irods::exception& _e) {
+                printErrorStack(&_rei->rsComm->rError);
+                return ERROR(
+                        _e.code(),
+                        _e.what());
+            }
+        }
+        else if(irods::indexing::policy::object::index_multiple ==
+                _rule_obj["rule-engine-operation"]) {
+            try {
+                // proxy for provided user name
+                const std::string& user_name = _rule_obj["user-name"];
+                rstrcpy(
+                    _rei->rsComm->clientUser.userName,
+                    user_name.c_str(),
+                    NAME_LEN);
+
+                const std::string object_path = _rule_obj["object-path"];
+                apply_object_multiple_policy(
+                    _rei,
+                    object_path,
+                    _rule_obj["source-resource"],
+                    _rule_obj["indexer"],
+                    _rule_obj["index-names"].get<std::vector<std::string>>(),
+                    select_replicas_for_reading(
+                        _rei,
+                        {object_path},
+                        irods::indexing::index_type::full_text));
+            }
+            catch(const irods::exception& _e) {
+                printErrorStack(&_rei->rsComm->rError);
+                return ERROR(
+                        _e.code(),
+                        _e.what());
+            }
+        }
+        else if(irods::indexing::policy::object::purge ==
+                _rule_obj["rule-engine-operation"]) {
+            try {
+                // proxy for provided user name
+                const std::string& user_name = _rule_obj["user-name"];
+                rstrcpy(
+                    _rei->rsComm->clientUser.userName,
+                    user_name.c_str(),
+                    NAME_LEN);
+
+                apply_object_policy(
+                    _rei,
+                    irods::indexing::policy::object::purge,
+                    _rule_obj["object-path"],
+                    _rule_obj["source-resource"],
+                    _rule_obj["indexer"],
+                    _rule_obj["index-name"],
+                    _rule_obj["index-type"]);
+            }
+            catch(const irods::exception& _e) {
+                printErrorStack(&_rei->rsComm->rError);
+                return ERROR(
+                        _e.code(),
+                        _e.what());
+            }
+        }
+        else if(irods::indexing::policy::object::index_batch ==
+                _rule_obj["rule-engine-operation"] ||
+                irods::indexing::policy::object::purge_batch ==
+                _rule_obj["rule-engine-operation"]) {
+            try {
+                // proxy for provided user name
+                const std::string& user_name = _rule_obj["user-name"];
+                rstrcpy(
+                    _rei->rsComm->clientUser.userName,
+                    user_name.c_str(),
+                    NAME_LEN);
+
+                const std::vector<std::string> object_paths = _rule_obj["object-paths"];
+                const bool reads_data = irods::indexing::policy::object::index_batch ==
+                                        _rule_obj["rule-engine-operation"];
+                apply_object_batch_policy(
+                    _rei,
+                    _rule_obj["rule-engine-operation"],
+                    object_paths,
+                    _rule_obj["source-resource"],
+                    _rule_obj["indexer"],
+                    _rule_obj["index-name"],
+                    _rule_obj["index-type"],
+                    reads_data ?
+                        select_replicas_for_reading(
+                            _rei,
+                            object_paths,
+                            _rule_obj["index-type"]) :
+                        std::string{});
+            }
+            catch(const irods::exception& _e) {
+                printErrorStack(&_rei->rsComm->rError);
+                return ERROR(
+                        _e.code(),
+                        _e.what());
+            }
+        }
+        else if(irods::indexing::policy::metadata::index_batch ==
+                _rule_obj["rule-engine-operation"] ||
+                irods::indexing::policy::metadata::purge_batch ==
+                _rule_obj["rule-engine-operation"]) {
+            try {
+                // proxy for provided user name
+                const std::string& user_name = _rule_obj["user-name"];
+                rstrcpy(
+                    _rei->rsComm->clientUser.userName,
+                    user_name.c_str(),
+                    NAME_LEN);
+
+                const std::string& operation = _rule_obj["rule-engine-operation"];
+                apply_metadata_batch_policy(
+                    _rei,
+                    irods::indexing::policy::metadata::index_batch == operation ?
+                        irods::indexing::policy::metadata::index :
+                        irods::indexing::policy::metadata::purge,
+                    _rule_obj["object-paths"],
+                    _rule_obj["indexer"],
+                    _rule_obj["index-name"]);
+            }
+            catch(const irods::exception& _e) {
+                printErrorStack(&_rei->rsComm->rError);
+                return ERROR(
+                        _e.code(),
+                        _e.what());
+            }
+        }
+        else if(irods::indexing::policy::collection::index ==
+                _rule_obj["rule-engine-operation"]) {
+
+            irods::indexing::indexer idx{_rei, instance_name};
+            idx.schedule_policy_events_for_collection(
+                irods::indexing::operation_type::index,
+                get_collection_names(_rule_obj),
+                _rule_obj["user-name"],
+                _rule_obj["indexer"],
+                _rule_obj["index-name"],
+                _rule_obj["index-type"],
+                _rule_obj.value("continuation-token", std::string{}));
+        }
+        else if(irods::indexing::policy::collection::purge ==
+                _rule_obj["rule-engine-operation"]) {
+
+            irods::indexing::indexer idx{_rei, instance_name};
+            idx.purge_collections(
+                get_collection_names(_rule_obj),
+                _rule_obj["user-name"],
+                _rule_obj["indexer"],
+                _rule_obj["index-name"],
+                _rule_obj["index-type"],
+                _rule_obj.value("continuation-token", std::string{}));
+        }
+        else if(irods::indexing::policy::collection::reconcile ==
+                _rule_obj["rule-engine-operation"]) {
+
+            irods::indexing::indexer idx{_rei, instance_name};
+            idx.reconcile_collection(
+                _rule_obj["collection-name"],
+                _rule_obj["user-name"],
+                _rule_obj["indexer"],
+                _rule_obj["index-name"],
+                _rule_obj["index-type"]);
+        }
+        else if(irods::indexing::policy::metadata::update ==
+                _rule_obj["rule-engine-operation"]) {
+            try {
+                // proxy for provided user name
+                const std::string& user_name = _rule_obj["user-name"];
+                rstrcpy(
                     _rei->rsComm->clientUser.userName,
-                    source_resource);
-            }
-            else if("pep_api_data_obj_open_post"   == _rn ||
-                    "pep_api_data_obj_create_post" == _rn) {
-                auto it = _args.begin();
-                std::advance(it, 2);
-                if(_args.end() == it) {
-                    THROW(
-                        SYS_INVALID_INPUT_PARAM,
-                        "invalid number of arguments");
-                }
+                    user_name.c_str(),
+                    NAME_LEN);
 
-                auto obj_inp = boost::any_cast<dataObjInp_t*>(*it);
-                if(obj_inp->openFlags & O_WRONLY || obj_inp->openFlags & O_RDWR) {
-                    int l1_idx{};
-                    std::string resource_name;
-                    try {
-                        std::tie(l1_idx, resource_name) = get_index_and_resource(obj_inp);
-                        opened_objects[l1_idx] = std::tie(obj_inp->objPath, resource_name);
-                    }
-                    catch(const irods::exception& _e) {
-                        rodsLog(
-                           LOG_ERROR,
-                           "get_index_and_resource failed for [%s]",
-                           obj_inp->objPath);
-                    }
-                }
+                // the avus are handed to the technology as json arrays
+                const std::string& indexer = _rule_obj["indexer"];
+                std::list<boost::any> args;
+                args.push_back(boost::any(_rule_obj["object-path"].get<std::string>()));
+                args.push_back(boost::any(_rule_obj["avus-added"].dump()));
+                args.push_back(boost::any(_rule_obj["avus-removed"].dump()));
+                args.push_back(boost::any(_rule_obj["index-name"].get<std::string>()));
+                irods::indexing::invoke_policy(
+                    _rei,
+                    irods::indexing::policy::compose_policy_name(
+                        irods::indexing::policy::metadata::update,
+                        indexer),
+                    args);
             }
-            else if("pep_api_data_obj_close_post" == _rn) {
-                //TODO :: only for create/write events
-                auto it = _args.begin();
-                std::advance(it, 2);
-                if(_args.end() == it) {
-                    THROW(
-                        SYS_INVALID_INPUT_PARAM,
-                        "invalid number of arguments");
-                }
-
-                const auto opened_inp = boost::any_cast<openedDataObjInp_t*>(*it);
-                const auto l1_idx = opened_inp->l1descInx;
-                if(opened_objects.find(l1_idx) != opened_objects.end()) {
-                    std::string object_path, resource_name;
-                    std::tie(object_path, resource_name) = opened_objects[l1_idx];
-                    irods::indexing::indexer idx{_rei, config->instance_name_};
-                    idx.schedule_full_text_indexing_event(
-                        object_path,
-                        _rei->rsComm->clientUser.userName,
-                        resource_name);
-                }
+            catch(const irods::exception& _e) {
+                printErrorStack(&_rei->rsComm->rError);
+                return ERROR(
+                        _e.code(),
+                        _e.what());
             }
-            else if("pep_api_mod_avu_metadata_pre" == _rn) {
-                auto it = _args.begin();
-                std::advance(it, 2);
-                if(_args.end() == it) {
-                    THROW(
-                        SYS_INVALID_INPUT_PARAM,
-                        "invalid number of arguments");
-                }
-
-                const auto avu_inp = boost::any_cast<modAVUMetadataInp_t*>(*it);
-                const std::string attribute{avu_inp->arg3};
-                if(config->index != attribute) {
-                    return;
-                }
+        }
+        else if(irods::indexing::policy::object::rename ==
+                _rule_obj["rule-engine-operation"] ||
+                irods::indexing::policy::collection::rename ==
+                _rule_obj["rule-engine-operation"]) {
+            try {
+                // proxy for provided user name
+                const std::string& user_name = _rule_obj["user-name"];
+                rstrcpy(
+                    _rei->rsComm->clientUser.userName,
+                    user_name.c_str(),
+                    NAME_LEN);
 
-                const std::string operation{avu_inp->arg0};
-                const std::string type{avu_inp->arg1};
-                const std::string object_path{avu_inp->arg2};
-                const std::string add{"add"};
-                const std::string set{"set"};
-                const std::string collection{"-C"};
-
-                irods::indexing::indexer idx{_rei, config->instance_name_};
-                if(operation == set || operation == add) {
-                    if(type == collection) {
-                        // was the added tag an indexing indicator
-                        if(config->index == attribute) {
-                            // verify that this is not new metadata with a query and set a flag
-                            if (!avu_inp->arg3) { THROW( SYS_INVALID_INPUT_PARAM, "empty metadata attribute" ); }
-                            if (!avu_inp->arg4) { THROW( SYS_INVALID_INPUT_PARAM, "empty metadata value" ); }
-                            collection_metadata_is_new = !idx.metadata_exists_on_collection(
-                                                             object_path,
-                                                             avu_inp->arg3,
-                                                             avu_inp->arg4,
-                                                             NULL_PTR_GUARD(avu_inp->arg5));
-                        }
-                    }
-                }
-            }
-            else if("pep_api_mod_avu_metadata_post" == _rn) {
-                auto it = _args.begin();
-                std::advance(it, 2);
-                if(_args.end() == it) {
-                    THROW(
-                        SYS_INVALID_INPUT_PARAM,
-                        "invalid number of arguments");
-                }
+                const std::string& operation        = _rule_obj["rule-engine-operation"];
+                const std::string& destination_path = _rule_obj["destination-path"];
+                const std::string& indexer          = _rule_obj["indexer"];
+                const std::string& index_name       = _rule_obj["index-name"];
+                const std::string& index_type       = _rule_obj["index-type"];
 
-                const auto avu_inp = boost::any_cast<modAVUMetadataInp_t*>(*it);
-                const std::string operation{avu_inp->arg0};
-                const std::string type{avu_inp->arg1};
-                const std::string collection_name{avu_inp->arg2};
-
-                if (!avu_inp->arg3) { THROW( SYS_INVALID_INPUT_PARAM, "empty metadata attribute" ); }
-                if (!avu_inp->arg4) { THROW( SYS_INVALID_INPUT_PARAM, "empty metadata value" ); }
-                const std::string attribute{ avu_inp->arg3 };
-                const std::string value{ avu_inp->arg4 };
-                const std::string units{ NULL_PTR_GUARD(avu_inp->arg5) };
-
-                const std::string add{"add"};
-                const std::string set{"set"};
-                const std::string rm{"rm"};
-                const std::string collection{"-C"};
-                const std::string data_object{"-d"};
-
-                irods::indexing::indexer idx{_rei, config->instance_name_};
-                if(operation == rm) {
-                    // removed index metadata from collection
-                    if(type == collection) {
-                        // was the removed tag an indexing indicator
-                        if(config->index == attribute) {
-                            // schedule a possible purge of all indexed data in collection
-                            idx.schedule_collection_operation(
-                                irods::indexing::operation_type::purge,
-                                collection_name,
-                                _rei->rsComm->clientUser.userName,
-                                value,
-                                units);
-                        }
-                    }
-                    // removed a single indexed AVU on an object
-                    if(type == data_object) {
-                        // schedule an AVU purge
-                        idx.schedule_metadata_purge_event(
-                                collection_name,
-                                _rei->rsComm->clientUser.userName,
-                                attribute,
-                                value,
-                                units);
+                std::list<boost::any> args;
+                args.push_back(boost::any(_rule_obj["source-path"].get<std::string>()));
+                args.push_back(boost::any(destination_path));
+                args.push_back(boost::any(index_name));
+                irods::indexing::invoke_policy(
+                    _rei,
+                    irods::indexing::policy::compose_policy_name(operation, indexer),
+                    args);
+
+                // documents moved out of an index are purged by their new path
+                if(_rule_obj.value("purge-destination", false)) {
+                    if(irods::indexing::policy::collection::rename == operation) {
+                        irods::indexing::indexer idx{_rei, instance_name};
+                        idx.purge_collections(
+                            {destination_path},
+                            user_name,
+                            indexer,
+                            index_name,
+                            index_type);
                     }
-                }
-                else if(operation == set || operation == add) {
-                    if(type == collection) {
-                        // was the added tag an indexing indicator
-                        if(config->index == attribute) {
-                            // check the verify flag
-                            if(collection_metadata_is_new) {
-                                idx.schedule_collection_operation(
-                                    irods::indexing::operation_type::index,
-                                    collection_name,
-                                    _rei->rsComm->clientUser.userName,
-                                    value,
-                                    units);
-                            }
-                        }
+                    else if(irods::indexing::index_type::full_text == index_type) {
+                        apply_object_policy(
+                            _rei,
+                            irods::indexing::policy::object::purge,
+                            destination_path,
+                            irods::indexing::indexer::EMPTY_RESOURCE_NAME,
+                            indexer,
+                            index_name,
+                            index_type);
                     }
-                    if(type == data_object) {
-                        idx.schedule_metadata_indexing_event(
-                                collection_name,
-                                _rei->rsComm->clientUser.userName,
-                                attribute,
-                                value,
-                                units);
+                    else {
+                        apply_metadata_policy(
+                            _rei,
+                            irods::indexing::policy::metadata::purge,
+                            destination_path,
+                            indexer,
+                            index_name,
+                            {},
+                            {},
+                            {});
                     }
                 }
             }
-            else if("pep_api_data_obj_unlink_post" == _rn) {
-                auto it = _args.begin();
-                std::advance(it, 2);
-                if(_args.end() == it) {
-                    THROW(
-                        SYS_INVALID_INPUT_PARAM,
-                        "invalid number of arguments");
-                }
-
-                const auto obj_inp = boost::any_cast<dataObjInp_t*>(*it);
-                irods::indexing::indexer idx{_rei, config->instance_name_};
-                idx.schedule_full_text_purge_event(
-                    obj_inp->objPath,
-                    _rei->rsComm->clientUser.userName);
+            catch(const irods::exception& _e) {
+                printErrorStack(&_rei->rsComm->rError);
+                return ERROR(
+                        _e.code(),
+                        _e.what());
             }
         }
-        catch(const boost::bad_any_cast& _e) {
-            THROW(
-                INVALID_ANY_CAST,
-                boost::str(boost::format(
-                    "function [%s] rule name [%s]")
-                    % __FUNCTION__ % _rn));
-        }
-    } // apply_indexing_policy
-
-    void apply_object_policy(
-        ruleExecInfo_t*    _rei,
-        const std::string& _policy_root,
-        const std::string& _object_path,
-        const std::string& _source_resource,
-        const std::string& _indexer,
-        const std::string& _index_name,
-        const std::string& _index_type) {
-        const std::string policy_name{irods::indexing::policy::compose_policy_name(
-                              _policy_root,
-                              _indexer)};
+        else if(irods::indexing::policy::instance::reload_configuration ==
+                _rule_obj["rule-engine-operation"]) {
+            if(_rei->rsComm->clientUser.authInfo.authFlag < LOCAL_PRIV_USER_AUTH) {
+                return ERROR(
+                        CAT_INSUFFICIENT_PRIVILEGE_LEVEL,
+                        "reloading the configuration requires rodsadmin");
+            }
 
-        std::list<boost::any> args;
-        args.push_back(boost::any(_object_path));
-        args.push_back(boost::any(_source_resource));
-        args.push_back(boost::any(_index_name));
-        args.push_back(boost::any(_index_type));
-        irods::indexing::invoke_policy(_rei, policy_name, args);
+            // indexers constructed from here on share the new snapshot, the
+            // size of a running worker pool is unchanged
+            try {
+                irods::indexing::reload_configuration(instance_name);
+            }
+            catch(const irods::exception& _e) {
+                return ERROR(
+                        _e.code(),
+                        _e.what());
+            }
 
-    } // apply_object_policy
+            rodsLog(
+                LOG_NOTICE,
+                "irods::indexing reloaded the configuration of [%s]",
+                instance_name.c_str());
+        }
+        else if(irods::indexing::policy::metadata::index ==
+                _rule_obj["rule-engine-operation"]) {
+            try {
+                // proxy for provided user name
+                const std::string& user_name = _rule_obj["user-name"];
+                rstrcpy(
+                    _rei->rsComm->clientUser.userName,
+                    user_name.c_str(),
+                    NAME_LEN);
 
-    void apply_metadata_policy(
-        ruleExecInfo_t*    _rei,
-        const std::string& _policy_root,
-        const std::string& _object_path,
-        const std::string& _indexer,
-        const std::string& _index_name,
-        const std::string& _attribute,
-        const std::string& _value,
-        const std::string& _units) {
-        const std::string policy_name{irods::indexing::policy::compose_policy_name(
-                              _policy_root,
-                              _indexer)};
+                apply_metadata_policy(
+                    _rei,
+                    irods::indexing::policy::metadata::index,
+                    _rule_obj["object-path"],
+                    _rule_obj["indexer"],
+                    _rule_obj["index-name"],
+                    _rule_obj["attribute"],
+                    _rule_obj["value"],
+                    _rule_obj["units"]);
+            }
+            catch(const irods::exception& _e) {
+                printErrorStack(&_rei->rsComm->rError);
+                return ERROR(
+                        _e.code(),
+                        _e.what());
+            }
+        }
+        else if(irods::indexing::policy::metadata::purge ==
+                _rule_obj["rule-engine-operation"]) {
+            try {
+                // proxy for provided user name
+                const std::string& user_name = _rule_obj["user-name"];
+                rstrcpy(
+                    _rei->rsComm->clientUser.userName,
+                    user_name.c_str(),
+                    NAME_LEN);
 
-        if(_attribute.empty() && _value.empty()) {
-            const boost::filesystem::path p{_object_path};
-            const std::string coll_name = p.parent_path().string();
-            const std::string data_name = p.filename().string();
-            const std::string query_str {
-                boost::str(
-                    boost::format("SELECT META_DATA_ATTR_NAME, META_DATA_ATTR_VALUE, META_DATA_ATTR_UNITS WHERE DATA_NAME = '%s' AND COLL_NAME = '%s'")
-                        % data_name
-                        % coll_name) };
-            irods::query<rsComm_t> qobj{_rei->rsComm, query_str};
-            for (const auto& result : qobj) {
-                std::list<boost::any> args;
-                args.push_back(boost::any(_object_path));
-                args.push_back(boost::any(result[0]));
-                args.push_back(boost::any(result[1]));
-                args.push_back(boost::any(result[2]));
-                args.push_back(boost::any(_index_name));
-                irods::indexing::invoke_policy(_rei, policy_name, args);
-            } // for
+                apply_metadata_policy(
+                    _rei,
+                    irods::indexing::policy::metadata::purge,
+                    _rule_obj["object-path"],
+                    _rule_obj["indexer"],
+                    _rule_obj["index-name"],
+                    _rule_obj["attribute"],
+                    _rule_obj["value"],
+                    _rule_obj["units"]);
+            }
+            catch(const irods::exception& _e) {
+                printErrorStack(&_rei->rsComm->rError);
+                return ERROR(
+                        _e.code(),
+                        _e.what());
+            }
         }
         else {
-            std::list<boost::any> args;
-            args.push_back(boost::any(_object_path));
-            args.push_back(boost::any(_attribute));
-            args.push_back(boost::any(_value));
-            args.push_back(boost::any(_units));
-            args.push_back(boost::any(_index_name));
-            irods::indexing::invoke_policy(_rei, policy_name, args);
+            printErrorStack(&_rei->rsComm->rError);
+            return ERROR(
+                    SYS_NOT_SUPPORTED,
+                    "supported rule name not found");
         }
-    } // apply_metadata_policy
 
+        return SUCCESS();
+    } // execute_indexing_job
 } // namespace
 
 
@@ -402,13 +1526,56 @@ irods::error start(
     irods::default_re_ctx&,
     const std::string& _instance_name ) {
     RuleExistsHelper::Instance()->registerRuleRegex("pep_api_.*");
-    config = std::make_unique<irods::indexing::configuration>(_instance_name);
+    instance_name = _instance_name;
+    irods::indexing::get_configuration(instance_name);
     return SUCCESS();
 } // start
 
 irods::error stop(
     irods::default_re_ctx&,
     const std::string& ) {
+    // schedule anything still buffered before the agent goes away, the
+    // events may land in the worker pool so it is stopped afterwards
+    if(!instance_name.empty() && agent_comm) {
+        ruleExecInfo_t rei{};
+        rei.rsComm = agent_comm;
+        rei.uoic   = &agent_comm->clientUser;
+        rei.uoip   = &agent_comm->proxyUser;
+        try {
+            flush_event_buffer(&rei);
+        }
+        catch(const irods::exception& _e) {
+            rodsLog(
+                LOG_ERROR,
+                "irods::indexing failed to schedule buffered events - [%s]",
+                _e.what());
+        }
+
+        const auto pending_jobs = irods::indexing::stop_worker_pool();
+        if(!pending_jobs.empty()) {
+            irods::indexing::indexer idx{&rei, instance_name};
+            for(const auto& job : pending_jobs) {
+                try {
+                    idx.schedule_delayed_indexing_policy(
+                        job.rule_text,
+                        job.delay_parameters);
+                }
+                catch(const irods::exception& _e) {
+                    rodsLog(
+                        LOG_ERROR,
+                        "irods::indexing failed to hand off job [%s] - [%s]",
+                        job.rule_text.c_str(),
+                        _e.what());
+                }
+            }
+
+            rodsLog(
+                get_config()->log_level,
+                "irods::indexing handed [%d] pending jobs to the delay server",
+                static_cast<int>(pending_jobs.size()));
+        }
+    }
+
     return SUCCESS();
 } // stop
 
@@ -416,17 +1583,7 @@ irods::error rule_exists(
     irods::default_re_ctx&,
     const std::string& _rn,
     bool&              _ret) {
-    const std::set<std::string> rules{
-                                    "pep_api_data_obj_open_post",
-                                    "pep_api_data_obj_create_post",
-                                    "pep_api_data_obj_repl_post",
-                                    "pep_api_data_obj_unlink_post",
-                                    "pep_api_mod_avu_metadata_pre",
-                                    "pep_api_mod_avu_metadata_post",
-                                    "pep_api_data_obj_close_post",
-                                    "pep_api_data_obj_put_post",
-                                    "pep_api_phy_path_reg_post"};
-    _ret = rules.find(_rn) != rules.end();
+    _ret = nullptr != find_pep_handler(_rn);
 
     return SUCCESS();
 } // rule_exists
@@ -445,6 +1602,7 @@ irods::error exec_rule(
     if(!err.ok()) {
         return err;
     }
+    agent_comm = rei->rsComm;
     try {
         apply_indexing_policy(_rn, rei, _args);
     }
@@ -494,37 +1652,45 @@ irods::error exec_rule_text(
         const auto rule_obj = json::parse(rule_text);
         const std::string& rule_engine_instance_name = rule_obj["rule-engine-instance-name"];
         // if the rule text does not have our instance name, fail
-        if(config->instance_name_ != rule_engine_instance_name) {
+        if(instance_name != rule_engine_instance_name) {
             return ERROR(
                     SYS_NOT_SUPPORTED,
                     "instance name not found");
         }
-#if 0
-        // catalog / index drift correction
-        if(irods::indexing::schedule::indexing ==
-           rule_obj["rule-engine-operation"]) {
-            ruleExecInfo_t* rei{};
-            const auto err = _eff_hdlr("unsafe_ms_ctx", &rei);
-            if(!err.ok()) {
-                return err;
-            }
 
-            const std::string& params = rule_obj["delay-parameters"];
+        ruleExecInfo_t* rei{};
+        const auto err = _eff_hdlr("unsafe_ms_ctx", &rei);
+        if(!err.ok()) {
+            return err;
+        }
+
+        // jobs proxy for the user they name, only the service account, as
+        // used by the worker pool and forwarded jobs, or an administrator
+        // may submit them
+        if(rei->rsComm->clientUser.authInfo.authFlag < LOCAL_PRIV_USER_AUTH) {
+            return ERROR(
+                    CAT_INSUFFICIENT_PRIVILEGE_LEVEL,
+                    "indexing jobs may only be submitted by a rodsadmin");
+        }
+
+        // a job submitted with delay parameters, such as a periodic drift
+        // correction, is scheduled rather than run
+        if(rule_obj.count("delay-parameters") > 0) {
+            const std::string params = rule_obj["delay-parameters"];
 
-            json delay_obj;
-            delay_obj["rule-engine-operation"] = irods::indexing::policy::indexing;
+            auto delay_obj = rule_obj;
+            delay_obj.erase("delay-parameters");
 
-            irods::indexing::indexer idx{rei, config->instance_name_};
-            idx.schedule_indexing_policy(
+            irods::indexing::indexer idx{rei, instance_name};
+            idx.schedule_delayed_indexing_policy(
                 delay_obj.dump(),
                 params);
         }
-        else
-#endif
-        {
-            return ERROR(
-                    SYS_NOT_SUPPORTED,
-                    "supported rule name not found");
+        else {
+            // jobs submitted by a worker pool thread or forwarded from
+            // another server
+            agent_comm = rei->rsComm;
+            return execute_indexing_job(rei, rule_obj);
         }
     }
     catch(const  std::invalid_argument& _e) {
@@ -562,143 +1728,12 @@ irods::error exec_rule_expression(
         return err;
     }
 
+    agent_comm = rei->rsComm;
     try {
         const auto rule_obj = json::parse(_rule_text);
-        if(irods::indexing::policy::object::index ==
-           rule_obj["rule-engine-operation"]) {
-            try {
-                // proxy for provided user name
-                const std::string& user_name = rule_obj["user-name"];
-                rstrcpy(
-                    rei->rsComm->clientUser.userName,
-                    user_name.c_str(),
-                    NAME_LEN);
-
-                apply_object_policy(
-                    rei,
-                    irods::indexing::policy::object::index,
-                    rule_obj["object-path"],
-                    rule_obj["source-resource"],
-                    rule_obj["indexer"],
-                    rule_obj["index-name"],
-                    rule_obj["index-type"]);
-            }
-            catch(const irods::exception& _e) {
-                printErrorStack(&rei->rsComm->rError);
-                return ERROR(
-                        _e.code(),
-                        _e.what());
-            }
-        }
-        else if(irods::indexing::policy::object::purge ==
-                rule_obj["rule-engine-operation"]) {
-            try {
-                // proxy for provided user name
-                const std::string& user_name = rule_obj["user-name"];
-                rstrcpy(
-                    rei->rsComm->clientUser.userName,
-                    user_name.c_str(),
-                    NAME_LEN);
-
-                apply_object_policy(
-                    rei,
-                    irods::indexing::policy::object::purge,
-                    rule_obj["object-path"],
-                    rule_obj["source-resource"],
-                    rule_obj["indexer"],
-                    rule_obj["index-name"],
-                    rule_obj["index-type"]);
-            }
-            catch(const irods::exception& _e) {
-                printErrorStack(&rei->rsComm->rError);
-                return ERROR(
-                        _e.code(),
-                        _e.what());
-            }
-        }
-        else if(irods::indexing::policy::collection::index ==
-                rule_obj["rule-engine-operation"]) {
-
-            irods::indexing::indexer idx{rei, config->instance_name_};
-            idx.schedule_policy_events_for_collection(
-                irods::indexing::operation_type::index,
-                rule_obj["collection-name"],
-                rule_obj["user-name"],
-                rule_obj["indexer"],
-                rule_obj["index-name"],
-                rule_obj["index-type"]);
-        }
-        else if(irods::indexing::policy::collection::purge ==
-                rule_obj["rule-engine-operation"]) {
-
-            irods::indexing::indexer idx{rei, config->instance_name_};
-            idx.schedule_policy_events_for_collection(
-                irods::indexing::operation_type::purge,
-                rule_obj["collection-name"],
-                rule_obj["user-name"],
-                rule_obj["indexer"],
-                rule_obj["index-name"],
-                rule_obj["index-type"]);
-        }
-        else if(irods::indexing::policy::metadata::index ==
-                rule_obj["rule-engine-operation"]) {
-            try {
-                // proxy for provided user name
-                const std::string& user_name = rule_obj["user-name"];
-                rstrcpy(
-                    rei->rsComm->clientUser.userName,
-                    user_name.c_str(),
-                    NAME_LEN);
-
-                apply_metadata_policy(
-                    rei,
-                    irods::indexing::policy::metadata::index,
-                    rule_obj["object-path"],
-                    rule_obj["indexer"],
-                    rule_obj["index-name"],
-                    rule_obj["attribute"],
-                    rule_obj["value"],
-                    rule_obj["units"]);
-            }
-            catch(const irods::exception& _e) {
-                printErrorStack(&rei->rsComm->rError);
-                return ERROR(
-                        _e.code(),
-                        _e.what());
-            }
-        }
-        else if(irods::indexing::policy::metadata::purge ==
-                rule_obj["rule-engine-operation"]) {
-            try {
-                // proxy for provided user name
-                const std::string& user_name = rule_obj["user-name"];
-                rstrcpy(
-                    rei->rsComm->clientUser.userName,
-                    user_name.c_str(),
-                    NAME_LEN);
-
-                apply_metadata_policy(
-                    rei,
-                    irods::indexing::policy::metadata::purge,
-                    rule_obj["object-path"],
-                    rule_obj["indexer"],
-                    rule_obj["index-name"],
-                    rule_obj["attribute"],
-                    rule_obj["value"],
-                    rule_obj["units"]);
-            }
-            catch(const irods::exception& _e) {
-                printErrorStack(&rei->rsComm->rError);
-                return ERROR(
-                        _e.code(),
-                        _e.what());
-            }
-        }
-        else {
-            printErrorStack(&rei->rsComm->rError);
-            return ERROR(
-                    SYS_NOT_SUPPORTED,
-                    "supported rule name not found");
+        const auto ret = execute_indexing_job(rei, rule_obj);
+        if(!ret.ok()) {
+            return ret;
         }
     }
     catch(const  std::invalid_argument& _e) {
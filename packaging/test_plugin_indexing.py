@@ -8,7 +8,7 @@ import os.path
 
 import zipfile
 import subprocess
-from time import sleep
+from time import sleep, time
 from textwrap import dedent
 
 if sys.version_info >= (2, 7):
@@ -26,6 +26,9 @@ from .. import paths
 from .. import lib
 import ustrings
 
+ELASTICSEARCH_URL = 'http://localhost:9100'
+INDEXING_INSTANCE = 'irods_rule_engine_plugin-indexing-instance'
+
 SOURCE_BOOKS_URL  = 'https://cdn.patricktriest.com/data/books.zip'
 SOURCE_BOOKS_PATH = '/tmp/scratch'
 SOURCE_BOOKS_SUBDIR  = 'books'
@@ -51,7 +54,7 @@ def get_source_books ():
     return retvalue
 
 @contextlib.contextmanager
-def indexing_plugin__installed(arg=None):
+def indexing_plugin__installed(arg=None, elasticsearch_arg=None):
     filename = paths.server_config_path()
     with lib.file_backed_up(filename):
         irods_config = IrodsConfig()
@@ -60,17 +63,16 @@ def indexing_plugin__installed(arg=None):
             {
                 "instance_name": "irods_rule_engine_plugin-indexing-instance",
                 "plugin_name": "irods_rule_engine_plugin-indexing",
-                "plugin_specific_configuration": {
-                }
+                "plugin_specific_configuration": dict(arg or {})
             },
             {
                 "instance_name": "irods_rule_engine_plugin-elasticsearch-instance",
                 "plugin_name": "irods_rule_engine_plugin-elasticsearch",
-                "plugin_specific_configuration": {
+                "plugin_specific_configuration": dict({
                     "hosts" : ["http://localhost:9100/"],
                     "bulk_count" : 100,
                     "read_size" : 4194304
-                }
+                }, **(elasticsearch_arg or {}))
             },
             {
                 "instance_name": "irods_rule_engine_plugin-document_type-instance",
@@ -87,6 +89,55 @@ def indexing_plugin__installed(arg=None):
             pass
 
 
+def create_indices():
+    lib.execute_command("""curl -X PUT -H'Content-Type: application/json' {0}/full_text_index""".format(ELASTICSEARCH_URL))
+    lib.execute_command("""curl -X PUT -H'Content-Type: application/json' {0}/full_text_index/_mapping/text """\
+                        """-d '{{ "properties" : {{ "object_path" : {{ "type" : "text" }}, "logical_path" : {{ "type" : "keyword" }}, "data" : {{ "type" : "text" }} }} }}'""".format(ELASTICSEARCH_URL))
+    lib.execute_command("""curl -X PUT -H'Content-Type: application/json' {0}/metadata_index""".format(ELASTICSEARCH_URL))
+    lib.execute_command("""curl -X PUT -H'Content-Type: application/json' {0}/metadata_index/_mapping/text """\
+                        """-d '{{ "properties" : {{ "object_path" : {{ "type" : "text" }}, "logical_path" : {{ "type" : "keyword" }}, "attribute" : {{ "type" : "text" }},"""\
+                        """ "value" : {{ "type" : "text" }}, "unit" : {{ "type" : "text" }} }} }}'""".format(ELASTICSEARCH_URL))
+
+def delete_indices():
+    lib.execute_command("""curl -X DELETE -H'Content-Type: application/json' {0}/full_text_index""".format(ELASTICSEARCH_URL))
+    lib.execute_command("""curl -X DELETE -H'Content-Type: application/json' {0}/metadata_index""".format(ELASTICSEARCH_URL))
+
+def search_index( index_name , query ):
+    out,_,rc = lib.execute_command_permissive(
+        """curl -s -X GET -H'Content-Type: application/json' {0}/{1}/_search?size=500 -d '{2}'""".format(
+            ELASTICSEARCH_URL, index_name, json.dumps({"query" : query})))
+    if rc != 0: return []
+    return [hit['_source'] for hit in json.loads(out).get('hits',{}).get('hits',[])]
+
+def documents_for_logical_path( index_name , logical_path ):
+    return search_index(index_name, {"term" : {"logical_path" : logical_path}})
+
+def documents_within_collection( index_name , collection_name ):
+    return search_index(index_name, {"prefix" : {"logical_path" : collection_name + "/"}})
+
+def wait_for( predicate , timeout = 90 , interval = 3 ):
+    deadline = time() + timeout
+    while time() < deadline:
+        if predicate(): return True
+        sleep(interval)
+    return predicate()
+
+def annotate_for_full_text( session , collection_name ):
+    session.assert_icommand('imkdir -p {0}'.format(collection_name))
+    session.assert_icommand("""imeta set -C {0} irods::indexing::index full_text_index::full_text elasticsearch""".format(collection_name))
+
+def put_text_object( session , logical_path , text ):
+    local_file = os.path.join(tempfile.mkdtemp(), os.path.basename(logical_path))
+    with open(local_file, 'w') as f:
+        f.write(text)
+    session.assert_icommand(['iput', '-fK', local_file, logical_path])
+    shutil.rmtree(os.path.dirname(local_file))
+
+def indexing_rule_text( operation , **parameters ):
+    rule_obj = {"rule-engine-operation" : operation, "rule-engine-instance-name" : INDEXING_INSTANCE}
+    rule_obj.update(parameters)
+    return json.dumps(rule_obj)
+
 def search_index_for_avu_attribute_name( index_name , attr_name ):
     out,_,rc = lib.execute_command_permissive( dedent("""\
         curl -X GET -H'Content-Type: application/json' HTTP://localhost:9100/{index_name}/text/_search?pretty=true -d '
@@ -137,13 +188,7 @@ class TestIndexingPlugin(ResourceBase, unittest.TestCase):
                 }
                 try:
                     ## Create index for each type
-                    lib.execute_command("""curl -X PUT -H'Content-Type: application/json' http://localhost:9100/full_text_index""")
-                    lib.execute_command("""curl -X PUT -H'Content-Type: application/json' http://localhost:9100/full_text_index/_mapping/text """\
-                                        """-d '{ "properties" : { "object_path" : { "type" : "text" }, "data" : { "type" : "text" } } }'""");
-                    lib.execute_command("""curl -X PUT -H'Content-Type: application/json' http://localhost:9100/metadata_index""")
-                    lib.execute_command("""curl -X PUT -H'Content-Type: application/json' http://localhost:9100/metadata_index/_mapping/text """\
-                                        """-d '{ "properties" : { "object_path" : { "type" : "text" }, "attribute" : { "type" : "text" },"""\
-                                        """ "value" : { "type" : "text" }, "unit" : { "type" : "text" } } }'""")
+                    create_indices()
                     for (key, collection_list) in indexed_collections.items():
                         keylist.setdefault( key, [] )
                         for collection in collection_list:
@@ -175,7 +220,463 @@ class TestIndexingPlugin(ResourceBase, unittest.TestCase):
                                              "Didn't find matches for target '{target}' in index '{key}_index' ".format(**locals()) )
                 finally:
                     # Delete index for each type
-                    lib.execute_command("""curl -X DELETE -H'Content-Type: application/json' http://localhost:9100/full_text_index""")
-                    lib.execute_command("""curl -X DELETE -H'Content-Type: application/json' http://localhost:9100/metadata_index""")
+                    delete_indices()
                     for collection in test_collections:
                         admin_session.assert_icommand("""irm -fr {c}""".format(c = collection))
+
+    def test_indexing_02_worker_pool(self):
+        with indexing_plugin__installed({"execution_mode" : "worker_pool"}):
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/worker_pool_coll'
+                logical_path = collection_name + '/worker_pool.txt'
+                create_indices()
+                try:
+                    annotate_for_full_text(admin_session, collection_name)
+                    put_text_object(admin_session, logical_path, 'indexed by a worker rather than the delay server')
+                    # jobs run by the pool of the putting agent never reach the delay queue
+                    out,_,_ = admin_session.run_icommand('iqstat -a')
+                    self.assertNotIn(logical_path, out)
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', logical_path)) > 0, timeout=30),
+                                    "worker pool did not index '{0}'".format(logical_path))
+                finally:
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_03_exec_rule_text_requires_rodsadmin(self):
+        with indexing_plugin__installed():
+            rule_text = indexing_rule_text(
+                            "irods_policy_indexing_object_index",
+                            **{"object-path" : self.admin.home_collection + '/anything',
+                               "user-name" : self.admin.username,
+                               "source-resource" : "",
+                               "indexer" : "elasticsearch",
+                               "index-name" : "full_text_index",
+                               "index-type" : "full_text"})
+            # a job runs as the user it names, so only a rodsadmin may submit one
+            self.user0.assert_icommand(['irule', '-r', INDEXING_INSTANCE, rule_text, 'null', 'ruleExecOut'],
+                                       'STDERR_SINGLELINE', 'CAT_INSUFFICIENT_PRIVILEGE_LEVEL')
+            self.user0.assert_icommand(['irule', '-r', INDEXING_INSTANCE,
+                                        indexing_rule_text("irods_policy_indexing_instance_reload_configuration"),
+                                        'null', 'ruleExecOut'],
+                                       'STDERR_SINGLELINE', 'CAT_INSUFFICIENT_PRIVILEGE_LEVEL')
+
+    def test_indexing_04_reconcile(self):
+        with indexing_plugin__installed():
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/reconcile_coll'
+                kept_path = collection_name + '/kept.txt'
+                lost_path = collection_name + '/lost.txt'
+                orphan_path = collection_name + '/orphan.txt'
+                create_indices()
+                try:
+                    annotate_for_full_text(admin_session, collection_name)
+                    put_text_object(admin_session, kept_path, 'a document which stays in the index')
+                    put_text_object(admin_session, lost_path, 'a document which drifts out of the index')
+                    for path in (kept_path, lost_path):
+                        self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', path)) > 0))
+
+                    # drift: one document is lost and one remains for an object not in the catalog
+                    lib.execute_command("""curl -s -X POST -H'Content-Type: application/json' {0}/full_text_index/_delete_by_query?refresh=true -d '{1}'""".format(
+                                            ELASTICSEARCH_URL, json.dumps({"query" : {"term" : {"logical_path" : lost_path}}})))
+                    lib.execute_command("""curl -s -X PUT -H'Content-Type: application/json' {0}/full_text_index/text/999999999_0?refresh=true -d '{1}'""".format(
+                                            ELASTICSEARCH_URL, json.dumps({"object_path" : orphan_path, "logical_path" : orphan_path, "data_id" : 999999999,
+                                                                           "chunk_index" : 0, "modify_time" : 0, "data" : "orphan"})))
+                    self.assertEqual(0, len(documents_for_logical_path('full_text_index', lost_path)))
+
+                    admin_session.assert_icommand(['irule', '-r', INDEXING_INSTANCE,
+                                                   indexing_rule_text("irods_policy_indexing_collection_reconcile",
+                                                                      **{"collection-name" : collection_name,
+                                                                         "user-name" : admin_session.username,
+                                                                         "indexer" : "elasticsearch",
+                                                                         "index-name" : "full_text_index",
+                                                                         "index-type" : "full_text"}),
+                                                   'null', 'ruleExecOut'])
+
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', lost_path)) > 0),
+                                    "reconcile did not reindex '{0}'".format(lost_path))
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', orphan_path)) == 0),
+                                    "reconcile did not purge '{0}'".format(orphan_path))
+                    self.assertTrue(len(documents_for_logical_path('full_text_index', kept_path)) > 0)
+                finally:
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_05_unchanged_content(self):
+        with indexing_plugin__installed():
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/unchanged_coll'
+                logical_path = collection_name + '/unchanged.txt'
+                text = 'content which is put twice without change'
+                def modify_time_in_catalog():
+                    out,_,_ = admin_session.run_icommand(['iquest', '%s',
+                        "select DATA_MODIFY_TIME where COLL_NAME = '{0}' and DATA_NAME = '{1}'".format(
+                            collection_name, os.path.basename(logical_path))])
+                    return int(out.strip().split('\n')[0])
+                def modify_times_in_index():
+                    return set(d.get('modify_time') for d in documents_for_logical_path('full_text_index', logical_path))
+                create_indices()
+                try:
+                    annotate_for_full_text(admin_session, collection_name)
+                    put_text_object(admin_session, logical_path, text)
+                    self.assertTrue(wait_for(lambda: modify_times_in_index() == set([modify_time_in_catalog()])))
+
+                    # the same checksum and data id, only the modify time moves on
+                    sleep(2)
+                    put_text_object(admin_session, logical_path, text)
+                    second_modify_time = modify_time_in_catalog()
+                    self.assertTrue(wait_for(lambda: modify_times_in_index() == set([second_modify_time])),
+                                    "modify time of unchanged '{0}' was not updated".format(logical_path))
+                finally:
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_06_rename(self):
+        with indexing_plugin__installed():
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/rename_coll'
+                # a multibyte name, painless measures paths in utf-16 code units
+                source_collection = collection_name + '/sourc\xc3\xa9'
+                destination_collection = collection_name + '/destination'
+                object_path = source_collection + '/moved.txt'
+                renamed_path = source_collection + '/renamed.txt'
+                create_indices()
+                try:
+                    annotate_for_full_text(admin_session, collection_name)
+                    admin_session.assert_icommand(['imkdir', '-p', source_collection])
+                    put_text_object(admin_session, object_path, 'a document which is renamed without being read')
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', object_path)) > 0))
+
+                    admin_session.assert_icommand(['imv', object_path, renamed_path])
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', renamed_path)) > 0),
+                                    "documents of '{0}' were not renamed".format(object_path))
+                    self.assertEqual(0, len(documents_for_logical_path('full_text_index', object_path)))
+
+                    admin_session.assert_icommand(['imv', source_collection, destination_collection])
+                    moved_path = destination_collection + '/renamed.txt'
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', moved_path)) > 0),
+                                    "documents within '{0}' were not renamed".format(source_collection))
+                    self.assertEqual(0, len(documents_within_collection('full_text_index', source_collection)))
+                    for document in documents_for_logical_path('full_text_index', moved_path):
+                        self.assertEqual(moved_path, document['object_path'])
+                finally:
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_07_collection_purge(self):
+        with indexing_plugin__installed():
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/purge_coll'
+                # an underscore is a like wildcard, the sibling must survive the purge
+                purged_collection = collection_name + '/a_b'
+                sibling_collection = collection_name + '/aXb'
+                purged_paths = [purged_collection + '/one.txt', purged_collection + '/nested/two.txt']
+                sibling_path = sibling_collection + '/three.txt'
+                create_indices()
+                try:
+                    for c in (purged_collection, sibling_collection):
+                        annotate_for_full_text(admin_session, c)
+                    admin_session.assert_icommand(['imkdir', '-p', purged_collection + '/nested'])
+                    for path in purged_paths + [sibling_path]:
+                        put_text_object(admin_session, path, 'a document within ' + os.path.dirname(path))
+                    self.assertTrue(wait_for(lambda: len(documents_within_collection('full_text_index', purged_collection)) >= len(purged_paths)))
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', sibling_path)) > 0))
+
+                    admin_session.assert_icommand("""imeta rm -C {0} irods::indexing::index full_text_index::full_text elasticsearch""".format(purged_collection))
+                    self.assertTrue(wait_for(lambda: len(documents_within_collection('full_text_index', purged_collection)) == 0),
+                                    "documents within '{0}' were not purged".format(purged_collection))
+                    self.assertTrue(len(documents_for_logical_path('full_text_index', sibling_path)) > 0)
+                finally:
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_08_superseded_job(self):
+        with indexing_plugin__installed({"minimum_delay_time" : "10", "maximum_delay_time" : "12"}):
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/superseded_coll'
+                logical_path = collection_name + '/rewritten.txt'
+                create_indices()
+                try:
+                    annotate_for_full_text(admin_session, collection_name)
+                    log_offset = lib.get_file_size_by_path(paths.server_log_path())
+
+                    # both jobs are pending, the first finds its generation stale
+                    put_text_object(admin_session, logical_path, 'the first version')
+                    sleep(2)
+                    put_text_object(admin_session, logical_path, 'the second version')
+                    self.assertTrue(wait_for(lambda: [d['data'] for d in documents_for_logical_path('full_text_index', logical_path)] == ['the second version']),
+                                    "latest content of '{0}' was not indexed".format(logical_path))
+                    self.assertTrue(wait_for(lambda: lib.count_occurrences_of_string_in_log(
+                        paths.server_log_path(), 'superseded by a later write', start_index=log_offset) >= 1))
+                finally:
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_09_dynamically_mapped_index(self):
+        with indexing_plugin__installed():
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/dynamic_coll'
+                logical_path = collection_name + '/dynamic.txt'
+                def documents():
+                    return search_index('full_text_index', {"term" : {"object_path.keyword" : logical_path}})
+                # no explicit mapping, logical_path is analyzed and documents are matched by object_path.keyword
+                lib.execute_command("""curl -X PUT -H'Content-Type: application/json' {0}/full_text_index""".format(ELASTICSEARCH_URL))
+                try:
+                    annotate_for_full_text(admin_session, collection_name)
+                    put_text_object(admin_session, logical_path, 'a document within an index without a mapping')
+                    self.assertTrue(wait_for(lambda: len(documents()) > 0))
+
+                    admin_session.assert_icommand(['irm', '-f', logical_path])
+                    self.assertTrue(wait_for(lambda: len(documents()) == 0),
+                                    "documents of '{0}' were not purged by object_path".format(logical_path))
+                finally:
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_10_checksum_registration(self):
+        with indexing_plugin__installed(elasticsearch_arg={"register_checksums" : True}):
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/checksum_coll'
+                logical_path = collection_name + '/unchecksummed.txt'
+                local_file = os.path.join(tempfile.mkdtemp(), 'unchecksummed.txt')
+                with open(local_file, 'w') as f:
+                    f.write('content hashed as it is read for indexing')
+                create_indices()
+                try:
+                    annotate_for_full_text(admin_session, collection_name)
+                    admin_session.assert_icommand(['iput', local_file, logical_path])
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', logical_path)) > 0))
+                    self.assertTrue(wait_for(lambda: 'sha2:' in admin_session.run_icommand(['ils', '-L', logical_path])[0]),
+                                    "checksum of '{0}' was not registered".format(logical_path))
+                finally:
+                    shutil.rmtree(os.path.dirname(local_file))
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_11_atomic_metadata_annotation(self):
+        with indexing_plugin__installed():
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/atomic_coll'
+                logical_path = collection_name + '/annotated_atomically.txt'
+                request = json.dumps({"entity_name" : collection_name, "entity_type" : "collection", "operations" : [
+                    {"operation" : "add", "attribute" : "irods::indexing::index", "value" : "full_text_index::full_text", "units" : "elasticsearch"}]})
+                rule_file = os.path.join(tempfile.mkdtemp(), 'atomic_apply.r')
+                with open(rule_file, 'w') as f:
+                    f.write(dedent('''\
+                        main {{
+                            msi_atomic_apply_metadata_operations(*request, *output);
+                        }}
+                        INPUT *request="{0}"
+                        OUTPUT ruleExecOut
+                        ''').format(request.replace('"', '\\"')))
+                create_indices()
+                try:
+                    admin_session.assert_icommand(['imkdir', '-p', collection_name])
+                    put_text_object(admin_session, logical_path, 'a document within a collection annotated atomically')
+                    admin_session.assert_icommand(['irule', '-r', 'irods_rule_engine_plugin-irods_rule_language-instance', '-F', rule_file])
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', logical_path)) > 0),
+                                    "annotation applied atomically to '{0}' did not index its objects".format(collection_name))
+                finally:
+                    shutil.rmtree(os.path.dirname(rule_file))
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_12_registration(self):
+        with indexing_plugin__installed():
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/registered_coll'
+                local_directory = tempfile.mkdtemp()
+                local_file = os.path.join(local_directory, 'registered.txt')
+                nested_directory = os.path.join(local_directory, 'nested')
+                os.mkdir(nested_directory)
+                with open(local_file, 'w') as f:
+                    f.write('a file registered in place')
+                for name in ('one.txt', 'two.txt'):
+                    with open(os.path.join(nested_directory, name), 'w') as f:
+                        f.write('a file within a directory registered in place')
+                create_indices()
+                try:
+                    annotate_for_full_text(admin_session, collection_name)
+                    admin_session.assert_icommand(['ireg', local_file, collection_name + '/registered.txt'])
+                    admin_session.assert_icommand(['ireg', '-C', nested_directory, collection_name + '/nested'])
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', collection_name + '/registered.txt')) > 0),
+                                    "registered file was not indexed")
+                    self.assertTrue(wait_for(lambda: len(documents_within_collection('full_text_index', collection_name + '/nested')) >= 2),
+                                    "files within the registered directory were not indexed")
+                finally:
+                    delete_indices()
+                    admin_session.run_icommand('irm -rfU {0}'.format(collection_name))
+                    shutil.rmtree(local_directory)
+
+    def test_indexing_13_replication_of_indexed_object(self):
+        with indexing_plugin__installed({"minimum_delay_time" : "30", "maximum_delay_time" : "31"}):
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/replicated_coll'
+                logical_path = collection_name + '/replicated.txt'
+                def pending_jobs():
+                    out,_,_ = admin_session.run_icommand(['iquest', '%s', "select RULE_EXEC_NAME where RULE_EXEC_NAME like '%{0}%'".format(
+                        os.path.basename(logical_path))])
+                    return [l for l in out.split('\n') if logical_path in l]
+                create_indices()
+                try:
+                    annotate_for_full_text(admin_session, collection_name)
+                    put_text_object(admin_session, logical_path, 'a document whose content is read once for all replicas')
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', logical_path)) > 0))
+                    self.assertTrue(wait_for(lambda: len(pending_jobs()) == 0))
+
+                    # the replica on demoResc is good and indexable, the new one adds no content
+                    admin_session.assert_icommand(['irepl', '-R', 'TestResc', logical_path])
+                    sleep(5)
+                    self.assertEqual([], pending_jobs())
+                finally:
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_14_resource_cache_expiry(self):
+        with indexing_plugin__installed({"minimum_delay_time" : "1", "maximum_delay_time" : "2", "resource_cache_ttl_in_seconds" : 5}):
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/resource_cache_coll'
+                logical_path = collection_name + '/on_demo_resource.txt'
+                create_indices()
+                try:
+                    # only TestResc is tagged, the crawl skips the replica on demoResc
+                    admin_session.assert_icommand('imeta set -R TestResc irods::indexing::index true')
+                    admin_session.assert_icommand(['imkdir', '-p', collection_name])
+                    put_text_object(admin_session, logical_path, 'a document on a resource tagged after the first crawl')
+                    annotate_for_full_text(admin_session, collection_name)
+                    sleep(15)
+                    self.assertEqual([], documents_for_logical_path('full_text_index', logical_path))
+
+                    # the tag on demoResc is seen once the cached resource names expire
+                    admin_session.assert_icommand('imeta set -R demoResc irods::indexing::index true')
+                    sleep(10)
+                    admin_session.assert_icommand("""imeta rm -C {0} irods::indexing::index full_text_index::full_text elasticsearch""".format(collection_name))
+                    annotate_for_full_text(admin_session, collection_name)
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', logical_path)) > 0),
+                                    "crawl did not pick up the newly tagged resource")
+                finally:
+                    admin_session.run_icommand('imeta rm -R TestResc irods::indexing::index true')
+                    admin_session.run_icommand('imeta rm -R demoResc irods::indexing::index true')
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_15_collection_annotation_change(self):
+        with indexing_plugin__installed({"collection_cache_ttl_in_seconds" : 5}):
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/annotation_change_coll'
+                nested_name = collection_name + '/first/second'
+                create_indices()
+                try:
+                    # objects are routed by the closest annotated ancestor
+                    annotate_for_full_text(admin_session, collection_name)
+                    admin_session.assert_icommand(['imkdir', '-p', nested_name])
+                    put_text_object(admin_session, nested_name + '/annotated.txt', 'a document below an annotated collection')
+                    self.assertTrue(wait_for(lambda: len(documents_for_logical_path('full_text_index', nested_name + '/annotated.txt')) > 0))
+
+                    admin_session.assert_icommand("""imeta rm -C {0} irods::indexing::index full_text_index::full_text elasticsearch""".format(collection_name))
+                    self.assertTrue(wait_for(lambda: len(documents_within_collection('full_text_index', collection_name)) == 0))
+                    sleep(10)
+                    put_text_object(admin_session, nested_name + '/unannotated.txt', 'a document put after the annotation was removed')
+                    sleep(30)
+                    self.assertEqual([], documents_for_logical_path('full_text_index', nested_name + '/unannotated.txt'))
+
+                    # an annotation on an intermediate collection is picked up as well
+                    annotate_for_full_text(admin_session, collection_name + '/first')
+                    self.assertTrue(wait_for(lambda: len(documents_within_collection('full_text_index', nested_name)) >= 2),
+                                    "change of collection annotations was not picked up")
+                finally:
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_16_crawl_resumes_from_checkpoint(self):
+        with indexing_plugin__installed({"minimum_delay_time" : "10", "maximum_delay_time" : "12",
+                                         "collection_crawl_checkpoint_interval" : 2, "collection_batch_size" : 1}):
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/checkpoint_coll'
+                logical_paths = [collection_name + '/object_{0}.txt'.format(i) for i in range(6)]
+                def continuation():
+                    # the rule text spans lines, so the id is queried on its own
+                    condition = "where RULE_EXEC_NAME like '%continuation-token%' and RULE_EXEC_NAME like '%{0}%'".format(collection_name)
+                    out,_,rc = admin_session.run_icommand(['iquest', '%s', 'select RULE_EXEC_ID ' + condition])
+                    if rc != 0 or not out.strip().isdigit(): return None
+                    rule_id = out.strip()
+                    out,_,_ = admin_session.run_icommand(['iquest', '%s', 'select RULE_EXEC_NAME ' + condition])
+                    return rule_id, json.loads(out[out.index('{'):out.rindex('}') + 1])
+                def indexed_count():
+                    return len(documents_within_collection('full_text_index', collection_name))
+                create_indices()
+                try:
+                    admin_session.assert_icommand(['imkdir', '-p', collection_name])
+                    for path in logical_paths:
+                        put_text_object(admin_session, path, 'a document visited by a checkpointed crawl')
+                    log_offset = lib.get_file_size_by_path(paths.server_log_path())
+                    annotate_for_full_text(admin_session, collection_name)
+                    self.assertTrue(wait_for(lambda: continuation() is not None), "crawl did not checkpoint")
+
+                    # interrupt the crawl by removing its pending continuation
+                    rule_id, rule_obj = continuation()
+                    admin_session.assert_icommand(['iqdel', rule_id])
+                    self.assertTrue(wait_for(lambda: indexed_count() == 2))
+                    sleep(30)
+                    self.assertEqual(2, indexed_count())
+
+                    # resubmitting the continuation resumes after the checkpointed data id
+                    admin_session.assert_icommand(['irule', '-r', INDEXING_INSTANCE, json.dumps(rule_obj), 'null', 'ruleExecOut'])
+                    self.assertTrue(wait_for(lambda: indexed_count() == len(logical_paths), timeout=180),
+                                    "resumed crawl did not index the remaining objects")
+                    self.assertTrue(lib.count_occurrences_of_string_in_log(
+                        paths.server_log_path(), 'irods::indexing::indexer checkpoint of crawl of [{0}]'.format(collection_name),
+                        start_index=log_offset) >= 2)
+                finally:
+                    admin_session.run_icommand(['iqdel', '-a'])
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_17_priority_lanes(self):
+        with indexing_plugin__installed({"minimum_delay_time" : "60", "maximum_delay_time" : "61", "large_object_size_in_bytes" : 64,
+                                         "small_full_text_priority" : 6, "large_full_text_priority" : 4}):
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/priority_coll'
+                small_path = collection_name + '/small.txt'
+                large_path = collection_name + '/large.txt'
+                def pending_priorities(logical_path):
+                    out,_,_ = admin_session.run_icommand(['iquest', '%s', "select RULE_EXEC_PRIORITY where RULE_EXEC_NAME like '%{0}%'".format(logical_path)])
+                    return [l.strip() for l in out.split('\n') if l.strip().isdigit()]
+                create_indices()
+                try:
+                    annotate_for_full_text(admin_session, collection_name)
+                    put_text_object(admin_session, small_path, 'small')
+                    put_text_object(admin_session, large_path, 'a document at least as large as the large object size ' * 4)
+                    self.assertEqual(['6'], pending_priorities(small_path))
+                    self.assertEqual(['4'], pending_priorities(large_path))
+                finally:
+                    admin_session.run_icommand(['iqdel', '-a'])
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
+
+    def test_indexing_18_archive_only_objects_deferred(self):
+        with indexing_plugin__installed({"minimum_delay_time" : "60", "maximum_delay_time" : "61", "defer_archive_only_objects" : True,
+                                         "archive_read_cost" : 100, "small_full_text_priority" : 6, "bulk_priority" : 2}):
+            with session.make_session_for_existing_admin() as admin_session:
+                collection_name = admin_session.home_collection + '/archive_coll'
+                archived_path = collection_name + '/archived.txt'
+                online_path = collection_name + '/online.txt'
+                local_file = os.path.join(tempfile.mkdtemp(), 'online.txt')
+                with open(local_file, 'w') as f:
+                    f.write('a document on a resource which is cheap to read')
+                def pending_priorities(logical_path):
+                    out,_,_ = admin_session.run_icommand(['iquest', '%s', "select RULE_EXEC_PRIORITY where RULE_EXEC_NAME like '%{0}%'".format(logical_path)])
+                    return [l.strip() for l in out.split('\n') if l.strip().isdigit()]
+                create_indices()
+                try:
+                    admin_session.assert_icommand('imeta set -R demoResc irods::indexing::read_cost 100')
+                    annotate_for_full_text(admin_session, collection_name)
+                    put_text_object(admin_session, archived_path, 'a document whose only replica is on archive storage')
+                    admin_session.assert_icommand(['iput', '-R', 'TestResc', local_file, online_path])
+                    self.assertEqual(['2'], pending_priorities(archived_path))
+                    self.assertEqual(['6'], pending_priorities(online_path))
+                finally:
+                    admin_session.run_icommand(['iqdel', '-a'])
+                    admin_session.run_icommand('imeta rm -R demoResc irods::indexing::read_cost 100')
+                    shutil.rmtree(os.path.dirname(local_file))
+                    delete_indices()
+                    admin_session.run_icommand('irm -rf {0}'.format(collection_name))
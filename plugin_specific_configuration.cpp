@@ -2,6 +2,58 @@
 #include "plugin_specific_configuration.hpp"
 #include "irods_server_properties.hpp"
 #include "irods_exception.hpp"
+#include "irods_get_full_path_for_config_file.hpp"
+
+#include <fstream>
+#include <vector>
+#include <sys/stat.h>
+
+#include "json.hpp"
+
+namespace {
+    std::string get_server_config_path() {
+        std::string path;
+        const irods::error ret = irods::get_full_path_for_config_file("server_config.json", path);
+        if(!ret.ok()) {
+            THROW(ret.code(), ret.result());
+        }
+
+        return path;
+    } // get_server_config_path
+
+    // converted as the server converts its own configuration, objects to
+    // maps and arrays to vectors of boost::any
+    boost::any to_any(const nlohmann::json& _value) {
+        if(_value.is_object()) {
+            std::unordered_map<std::string, boost::any> object;
+            for(auto itr = _value.begin(); itr != _value.end(); ++itr) {
+                object[itr.key()] = to_any(itr.value());
+            }
+            return object;
+        }
+        else if(_value.is_array()) {
+            std::vector<boost::any> array;
+            for(const auto& element : _value) {
+                array.push_back(to_any(element));
+            }
+            return array;
+        }
+        else if(_value.is_string()) {
+            return _value.get<std::string>();
+        }
+        else if(_value.is_boolean()) {
+            return _value.get<bool>();
+        }
+        else if(_value.is_number_integer()) {
+            return _value.get<int>();
+        }
+        else if(_value.is_number_float()) {
+            return _value.get<double>();
+        }
+
+        return boost::any{};
+    } // to_any
+} // namespace
 
 namespace irods {
     namespace indexing {
@@ -35,6 +87,57 @@ namespace irods {
                 _instance_name);
         } // get_plugin_specific_configuration
 
+        plugin_specific_configuration read_plugin_specific_configuration(
+            const std::string& _instance_name ) {
+            const std::string path{get_server_config_path()};
+            std::ifstream in{path};
+            if(!in) {
+                THROW(
+                    FILE_OPEN_ERR,
+                    boost::format("failed to open [%s]") %
+                    path);
+            }
+
+            nlohmann::json server_config;
+            try {
+                in >> server_config;
+                for(const auto& rule_engine : server_config.at(CFG_PLUGIN_CONFIGURATION_KW).at(PLUGIN_TYPE_RULE_ENGINE)) {
+                    if(rule_engine.at(CFG_INSTANCE_NAME_KW).get<std::string>() != _instance_name) {
+                        continue;
+                    }
+
+                    if(rule_engine.count(CFG_PLUGIN_SPECIFIC_CONFIGURATION_KW) > 0) {
+                        return boost::any_cast<plugin_specific_configuration>(
+                                   to_any(rule_engine.at(CFG_PLUGIN_SPECIFIC_CONFIGURATION_KW)));
+                    }
+                } // for rule_engine
+            } catch ( const std::exception& e ) {
+                THROW(
+                    SYS_CONFIG_FILE_ERR,
+                    boost::format("failed to parse [%s] [%s]") %
+                    path %
+                    e.what());
+            }
+
+            THROW(
+                SYS_INVALID_INPUT_PARAM,
+                boost::format("failed to find configuration for indexing plugin [%s] in [%s]") %
+                _instance_name %
+                path);
+        } // read_plugin_specific_configuration
+
+        std::time_t get_server_config_modify_time() {
+            try {
+                struct stat st{};
+                if(0 == stat(get_server_config_path().c_str(), &st)) {
+                    return st.st_mtime;
+                }
+            }
+            catch(const irods::exception&) {}
+
+            return 0;
+        } // get_server_config_modify_time
+
 
     } // namespace indexing
 } // namespace irods
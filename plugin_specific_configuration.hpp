@@ -1,6 +1,7 @@
 #ifndef PLUGIN_SPECIFIC_CONFIGURATION_HPP
 #define PLUGIN_SPECIFIC_CONFIGURATION_HPP
 #include <string>
+#include <ctime>
 #include "boost/any.hpp"
 #include <unordered_map>
 #include "irods_exception.hpp"
@@ -10,6 +11,14 @@ namespace irods {
     namespace indexing {
         using plugin_specific_configuration = std::unordered_map<std::string, boost::any>;
         plugin_specific_configuration get_plugin_specific_configuration(const std::string& _instance_name);
+
+        // the plugin specific configuration as it stands in server_config.json
+        // on disk, rather than as the server read it when it started
+        plugin_specific_configuration read_plugin_specific_configuration(const std::string& _instance_name);
+
+        // the last modification time of server_config.json, zero when it
+        // cannot be determined
+        std::time_t get_server_config_modify_time();
     } // namespace indexing
 } // namespace irods
 #endif // PLUGIN_SPECIFIC_CONFIGURATION_HPP
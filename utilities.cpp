@@ -64,5 +64,19 @@ namespace irods {
             }
 
         } // invoke_policy
+
+        bool policy_exists(
+            ruleExecInfo_t*    _rei,
+            const std::string& _action) {
+            irods::rule_engine_context_manager<
+                irods::unit,
+                ruleExecInfo_t*,
+                irods::AUDIT_RULE> re_ctx_mgr(
+                        irods::re_plugin_globals->global_re_mgr,
+                        _rei);
+            bool ret_val{};
+            irods::error err = re_ctx_mgr.rule_exists(_action, ret_val);
+            return err.ok() && ret_val;
+        } // policy_exists
     } // namespace indexing
 } // namespace irods
@@ -20,6 +20,11 @@ namespace irods {
             ruleExecInfo_t*       _rei,
             const std::string&    _action,
             std::list<boost::any> _args);
+
+        // whether any rule engine plugin implements the given policy
+        bool policy_exists(
+            ruleExecInfo_t*    _rei,
+            const std::string& _action);
     } // namespace indexing
 } // namespace irods
 
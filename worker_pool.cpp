@@ -0,0 +1,212 @@
+#include "worker_pool.hpp"
+
+#include "rodsClient.h"
+#include "irods_configuration_keywords.hpp"
+
+namespace irods {
+    namespace indexing {
+        rcComm_t* connect_to_server(
+            const std::string& _host) {
+            rodsEnv env{};
+            const int env_err = getRodsEnv(&env);
+            if(env_err < 0) {
+                rodsLog(
+                    LOG_ERROR,
+                    "irods::indexing failed to read the environment [%d]",
+                    env_err);
+                return nullptr;
+            }
+
+            const std::string host = _host.empty() ? env.rodsHost : _host;
+
+            rErrMsg_t err_msg{};
+            rcComm_t* comm = rcConnect(
+                                 host.c_str(),
+                                 env.rodsPort,
+                                 env.rodsUserName,
+                                 env.rodsZone,
+                                 NO_RECONN,
+                                 &err_msg);
+            if(!comm) {
+                rodsLog(
+                    LOG_ERROR,
+                    "irods::indexing failed to connect to [%s] - [%d]",
+                    host.c_str(),
+                    err_msg.status);
+                return nullptr;
+            }
+
+            const int login_err = clientLogin(comm);
+            if(login_err < 0) {
+                rodsLog(
+                    LOG_ERROR,
+                    "irods::indexing failed to log in to [%s] - [%d]",
+                    host.c_str(),
+                    login_err);
+                rcDisconnect(comm);
+                return nullptr;
+            }
+
+            return comm;
+        } // connect_to_server
+
+        int execute_rule_text(
+            rcComm_t*          _comm,
+            const std::string& _instance_name,
+            const std::string& _rule_text) {
+            const std::string rule_text{"@external\n" + _rule_text};
+            if(rule_text.size() >= META_STR_LEN) {
+                return SYS_INVALID_INPUT_PARAM;
+            }
+
+            execMyRuleInp_t exec_inp{};
+            rstrcpy(exec_inp.myRule, rule_text.c_str(), META_STR_LEN);
+            rstrcpy(exec_inp.outParamDesc, "ruleExecOut", LONG_NAME_LEN);
+            addKeyVal(
+                &exec_inp.condInput,
+                irods::CFG_INSTANCE_NAME_KW.c_str(),
+                _instance_name.c_str());
+
+            msParamArray_t* out_params{};
+            const int status = rcExecMyRule(_comm, &exec_inp, &out_params);
+            clearKeyVal(&exec_inp.condInput);
+            if(out_params) {
+                clearMsParamArray(out_params, 1);
+                free(out_params);
+            }
+
+            return status;
+        } // execute_rule_text
+
+        worker_pool::worker_pool(
+            const std::string& _instance_name,
+            int                _thread_count,
+            int                _queue_size) :
+            instance_name_{_instance_name},
+            thread_count_{static_cast<std::size_t>(_thread_count)},
+            queue_size_{static_cast<std::size_t>(_queue_size)} {
+        } // ctor
+
+        worker_pool::~worker_pool() {
+            if(!threads_.empty()) {
+                stop();
+            }
+        } // dtor
+
+        bool worker_pool::try_submit(pending_job _job) {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                if(stopping_ || queue_.size() >= queue_size_) {
+                    return false;
+                }
+
+                // equal priorities keep their order of arrival
+                const int priority = _job.priority;
+                queue_.emplace(priority, std::move(_job));
+
+                // each thread holds a connection, and so an agent, of its own
+                // only start one when every thread is busy
+                if(idle_ < queue_.size() && threads_.size() < thread_count_) {
+                    threads_.emplace_back([this] { run(); });
+                }
+            }
+
+            ready_.notify_one();
+            return true;
+        } // try_submit
+
+        std::vector<pending_job> worker_pool::take_returned_jobs() {
+            std::lock_guard<std::mutex> lock{mutex_};
+            std::vector<pending_job> ret_val;
+            ret_val.swap(returned_);
+            return ret_val;
+        } // take_returned_jobs
+
+        std::vector<pending_job> worker_pool::stop() {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                stopping_ = true;
+            }
+
+            // jobs in flight run to completion, handing them to the delay
+            // server as well would index the same objects twice
+
+            ready_.notify_all();
+            for(auto& t : threads_) {
+                t.join();
+            }
+            threads_.clear();
+
+            std::lock_guard<std::mutex> lock{mutex_};
+            std::vector<pending_job> ret_val;
+            ret_val.swap(returned_);
+            for(auto& job : queue_) {
+                ret_val.push_back(std::move(job.second));
+            }
+            queue_.clear();
+
+            return ret_val;
+        } // stop
+
+        void worker_pool::run() {
+            rcComm_t* comm{};
+            while(true) {
+                pending_job job;
+                {
+                    std::unique_lock<std::mutex> lock{mutex_};
+                    ++idle_;
+                    ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                    --idle_;
+                    if(stopping_) {
+                        break;
+                    }
+
+                    job = std::move(queue_.begin()->second);
+                    queue_.erase(queue_.begin());
+                }
+
+                // a failed job is retried by the delay server as any other
+                if(!execute(comm, job)) {
+                    std::lock_guard<std::mutex> lock{mutex_};
+                    returned_.push_back(std::move(job));
+                }
+            } // while
+
+            if(comm) {
+                rcDisconnect(comm);
+            }
+        } // run
+
+        bool worker_pool::execute(
+            rcComm_t*&         _comm,
+            const pending_job& _job) {
+            if(_job.rule_text.size() + sizeof("@external\n") > META_STR_LEN) {
+                return false;
+            }
+
+            if(!_comm) {
+                _comm = connect_to_server({});
+                if(!_comm) {
+                    return false;
+                }
+            }
+
+            const int status = execute_rule_text(_comm, instance_name_, _job.rule_text);
+
+            if(status < 0) {
+                rodsLog(
+                    LOG_ERROR,
+                    "irods::indexing::worker_pool job failed [%d] - [%s]",
+                    status,
+                    _job.rule_text.c_str());
+
+                // the connection may not survive the failure, start over
+                rcDisconnect(_comm);
+                _comm = nullptr;
+                return false;
+            }
+
+            return true;
+        } // execute
+    } // namespace indexing
+} // namespace irods
@@ -0,0 +1,83 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct rcComm_t;
+
+namespace irods {
+    namespace indexing {
+        // an indexing job as it would be handed to the delay server
+        struct pending_job {
+            std::string rule_text;
+            std::string delay_parameters;
+
+            // delay rule priority, higher runs first
+            int priority{};
+        }; // struct pending_job
+
+        // connect to a server of the local zone as the service account, the
+        // local server when _host is empty, or nullptr on failure
+        rcComm_t* connect_to_server(
+            const std::string& _host);
+
+        // execute a job through exec my rule against this plugin instance
+        int execute_rule_text(
+            rcComm_t*          _comm,
+            const std::string& _instance_name,
+            const std::string& _rule_text);
+
+        // threads executing indexing jobs directly against the local server,
+        // each over its own connection, fed by a bounded queue ordered by
+        // priority.  threads are started as jobs arrive, up to the limit
+        class worker_pool {
+            public:
+            worker_pool(
+                const std::string& _instance_name,
+                int                _thread_count,
+                int                _queue_size);
+
+            ~worker_pool();
+
+            worker_pool(const worker_pool&) = delete;
+            worker_pool& operator=(const worker_pool&) = delete;
+
+            // false when the queue is full or the pool is stopping, the caller
+            // then owns the job
+            bool try_submit(pending_job _job);
+
+            // jobs which could not be executed by a worker, to be handed to
+            // the delay server by the caller
+            std::vector<pending_job> take_returned_jobs();
+
+            // waits for jobs in flight and joins the workers, returns the jobs
+            // which never started along with those which failed
+            std::vector<pending_job> stop();
+
+            private:
+            void run();
+            bool execute(rcComm_t*& _comm, const pending_job& _job);
+
+            using job_queue = std::multimap<int, pending_job, std::greater<int>>;
+
+            const std::string        instance_name_;
+            const std::size_t        thread_count_;
+            const std::size_t        queue_size_;
+            std::mutex               mutex_;
+            std::condition_variable  ready_;
+            job_queue                queue_;
+            std::vector<pending_job> returned_;
+            std::vector<std::thread> threads_;
+            std::size_t              idle_{};
+            bool                     stopping_{};
+        }; // class worker_pool
+    } // namespace indexing
+} // namespace irods
+
+#endif // WORKER_POOL_HPP